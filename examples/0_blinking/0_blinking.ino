@@ -24,6 +24,10 @@
 unsigned char LEDS[] = {13, 11, 9};
 unsigned char GRNDS[] = {12, 10, 8};
 
+// a stack for loopBlink3 to use. giving a task its own array means its stack is counted in the
+// RAM usage printed when compiling, instead of begin() finding room for it at run time.
+uint8_t blink3Stack[0x80];
+
 // blinks 
 void loopBlink1();
 void loopBlink2();
@@ -34,7 +38,7 @@ void setup() {
     // this regesters these functions for the scheduler to call.
     OS.addTask(loopBlink1);
     OS.addTask(loopBlink2);
-    OS.addTask(loopBlink3);
+    OS.addTask(loopBlink3, blink3Stack);
 
     OS.begin();
     // execution never returns from begin
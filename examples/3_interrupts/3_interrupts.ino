@@ -40,7 +40,7 @@ void loop2();
 
 /**
  * @brief this interrupt gets fired when the button hooked up to pin btn gets pressed.
- * thus, it signals to loop2 to print out the current value of rnd when it gets the chance.
+ * thus, it hands loop2 the current value of rnd to print out when it gets the chance.
  * 
  * If the program regesters your button press twice. that is because of something called button bounce. 
  * There are techniques to mitigate that. However, they are beyond the scope of this example.
@@ -53,7 +53,10 @@ void loop2();
 void button();
 
 volatile int rnd;
-volatile bool toPrint = true;
+
+// the button ISR drops the current value of rnd in here for loop2 to print.
+// presses that come in faster than loop2 can print them wait in line instead of getting lost.
+SpscQueue<int, 8> presses;
 
 void setup() {
     noInterrupts();
@@ -89,24 +92,26 @@ void loop1() {
  * @brief this task is to detect whether to print out a number or not, and to print it if it should.
  */
 void loop2() {
-    if (toPrint) {
-        Serial.println(rnd);
-        toPrint = false;
+    int n;
+    // this task is not switched back in until the ISR puts something in the queue
+    if (presses.dequeue(n, WAIT_FOREVER)) {
+        Serial.println(n);
     }
-    OS.delay(50);
 }
 
 /**
  * @brief this interrupt gets fired when the button hooked up to pin btn gets pressed.
- * thus, it signals to loop2 to print out the current value of rnd when it gets the chance.
+ * thus, it hands loop2 the current value of rnd to print out when it gets the chance.
  * 
  * If the program regesters your button press twice. that is because of something called button bounce. 
  * There are techniques to mitigate that. However, they are beyond the scope of this example.
  */
 void button() {
-    noInterrupts();
-    toPrint = true;
-    interrupts();
+    // interrupts are already dissabled inside of an ISR, so use the FromISR version.
+    // if the queue is full, this press is simply dropped.
+    // rnd is volatile since loop1 changes it, so it has to be copied out before it can be passed by reference.
+    int n = rnd;
+    presses.enqueueFromISR(n);
 }
 /**
  * MIT License
@@ -24,9 +24,6 @@
 // this option is if you are using an exFAT SD card.
 //#define SdFat
 
-// this option is if you want to use delayUntil instead of just delay
-#define PRECISE_TIME
-
 // this option is for whether you have an exFAT SD card or not.
 #ifdef SdFat
     #include <SdFat.h>
@@ -66,7 +63,9 @@ void setup() {
         Serial.println(SD.begin(SD_CS_PIN));
     #endif
 
-    OS.addTask(listener, 256);
+    // the kernel releases listener every LOG_FREQ_MS on its own, so the logs never drift
+    // no matter how long writing to the card takes.
+    OS.addPeriodicTask(listener, LOG_FREQ_MS * 1000UL, 0, 256);
     OS.addTask(mainTask);
 
     OS.begin();
@@ -82,6 +81,7 @@ void mainTask() {
 
 
 // listens in to the reading variable and logs it to a log file on the SDcard every second.
+// it is called once per release, so there is no need to wait at the end.
 void listener() {
     // open the log file and use this file for future calls to listener.
     #ifdef SdFat
@@ -108,17 +108,6 @@ void listener() {
     log.flush();
     // release controll over the 
     SPILock.unlock();
-
-    // wait till next log time.
-    #ifdef PRECISE_TIME
-        // if you want to be extremely specific about the time you want to wait, then use this method.
-        static u32 t = millis();
-        t += LOG_FREQ_MS;
-        OS.delayUntil(t);
-    #else
-        // if you want to be simple, then use this method.
-        OS.delay(LOG_FREQ_MS);
-    #endif
 }
 
 /**
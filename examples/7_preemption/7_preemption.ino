@@ -1,17 +1,24 @@
 /**
  * @file 7_preemption.cpp
  * @author Alex Olson (aolson1714@gmail.com)
- * @brief this example uses 1_blinking_args.cpp as a base to allow for users to build their own preemptive kernel.
+ * @brief this example uses 1_blinking_args.cpp as a base to show off the preemptive kernel.
  * @version 0.1
  * @date 2022-03-23
  * 
  * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
  * 
  *  Purpose:
- *      To demonstrate how to set up basic preemption using ArdRTOS.
+ *      To demonstrate preemption in ArdRTOS.
+ *      uncomment PREEMPTIVE in ArdRTOS.h before running this.
+ *      The kernel then switches tasks on every tick of timer0, so tasks at the same priority take turns
+ *      even if they never yield, and a higher priority task that wakes up gets the processor right away.
+ *      The tick comes from ARDRTOS_TICK_VECTOR, and osTickSetup() can be defined to use a different timer.
+ * 
+ *      Preemption is only supported on AVR for now.
+ *      Use OS.suspendPreemption() and OS.resumePreemption() around code that another task must not interrupt.
  * 
  *  Required knowledge:
- *      Basic understanding of hardware timers in C++
+ *      Basic c++ programming.
  *      
  *  Required hardware:
  *      3 leds
@@ -20,20 +27,9 @@
 #include <ArdRTOS.h>
 #include <Arduino.h>
 
-/**
- * @brief Constructs the basic preemption context switcher.
- *      This is an advanced topic because it is highly dependant on the architecture of the microcontroller.
- *      This example is built for the ATmega128 and ATmega328.
- *      Check your test board to see if it uses one of those boards to see if this example   
- *      Known microcontrollers that will not support preemption:
- *          ARM Coretex-M based boards
- *          (more will be added as they are discovered)
- * 
- *      In order to set up preemption for your board, it is a good idea to learn how timers and interrupts work on your board.
- */
-ISR(TIMER0_COMPA_vect) {
-    OS.yield();
-}
+#ifndef PREEMPTIVE
+#error "uncomment PREEMPTIVE in ArdRTOS.h to run this example"
+#endif
 
 // to pass the inputs to the tasks.
 struct BlinkInputStruct{
@@ -54,20 +50,11 @@ void blink(void*);
  * 
  */
 void setup() {
-    // dissable interrupts as it would be disastrous if it tried to switch context durring setup.
-    noInterrupts();
-
-    // set overflowA num for timer 0
-    OCR0A = 20;
-    // enable overflowA interrupt on timer 0
-    TIMSK0 |= 1 << OCIE0A;
-
-
     OS.addTask(blink, &BIS1);
     OS.addTask(blink, &BIS2);
     OS.addTask(blink, &BIS3);
     
-    // OS.begin handles enabling interrupts at the appropriate time.
+    // OS.begin starts the tick once every task is ready to go.
     OS.begin();
 }
 
@@ -89,7 +76,7 @@ void blink(void* bis_inp) {
     for(;;){
         // notice how it is delay instead of OS.delay.
         // if preemption was not enabled, this would never pass processor time off to 
-        // the other tasks.
+        // the other tasks. OS.delay is still the better choice, since it lets the processor idle.
         digitalWrite(bis.LED, 1); delay(bis.DELAY);
         digitalWrite(bis.LED, 0); delay(bis.DELAY);
     }
@@ -0,0 +1,264 @@
+/**
+ * @file 96_BENCHMARK_SUITE.cpp
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief measures the kernel and the datatypes, and prints the results in a form scripts can read.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ *
+ *  Purpose:
+ *      To put numbers on ArdRTOS so that releases can be compared. It measures:
+ *          yield_round_trip    how long OS.yield() takes to come back with 2 to ARDRTOS_TASK_COUNT tasks taking turns
+ *          semaphore_free      a lock() and unlock() that never has to wait
+ *          semaphore_contended a lock() that has to wait for another task to unlock(), including the yields in between
+ *          queue_push_pop      an enqueue() and dequeue() on a Queue, for several sizes of item
+ *          stack_push_pop      a push() and pop() on a Stack, for several sizes of item
+ *          delay_jitter        how far apart OS.delayUntil() wakes a task that should wake every 2ms, minus those 2ms,
+ *                              while every other task is busy yielding. as a min, avg and max.
+ *
+ *      Every result is one csv line of benchmark,parameter,value,unit after a header line, so the output
+ *      of two releases can be diffed or loaded into a spreadsheet. Lines starting with # are comments.
+ *
+ *      This also runs on a pc with extras/host: make bench
+ *      There the timings come from the real clock of the pc, except for delay_jitter, which comes from the virtual clock.
+ *
+ *  Required knowledge:
+ *      Basic c++ programming.
+ *
+ *  Required hardware:
+ *      NONE
+ */
+
+#include <Arduino.h>
+#include "ArdRTOS.h"
+
+// how many times each operation is repeated per result
+#define ROUNDS 1000
+// how many times OS.delayUntil() is measured
+#define DELAYS 100
+
+#ifdef ARDRTOS_HOST
+#include <time.h>
+
+// a pc is much faster than micros(), so time it with its own clock there
+typedef unsigned long long Stamp;
+
+static inline Stamp stamp() {
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+static inline unsigned long nsSince(Stamp start) {
+    return stamp() - start;
+}
+#else
+typedef unsigned long Stamp;
+
+static inline Stamp stamp() {
+    return micros();
+}
+
+// each result takes well under the 4 seconds it takes for this to overflow
+static inline unsigned long nsSince(Stamp start) {
+    return (micros() - start) * 1000UL;
+}
+#endif
+
+// what the helper tasks do while they are running
+#define MODE_YIELD 0
+#define MODE_CONTENDED 1
+
+// how many tasks take part, counting the one running the benchmarks. the rest wait for a notification.
+volatile uint8_t active = 1;
+volatile uint8_t mode = MODE_YIELD;
+
+Semaphore lock;
+
+// runs every benchmark in order
+void bench();
+// the other tasks taking part in a benchmark
+void helper(void* arg);
+
+template<unsigned N>
+struct Bytes {
+    uint8_t b[N];
+};
+
+void report(const char* name, const char* param, unsigned long param_value, unsigned long value, const char* unit) {
+    Serial.print(name);
+    Serial.print(',');
+    Serial.print(param);
+    Serial.print('=');
+    Serial.print(param_value);
+    Serial.print(',');
+    Serial.print(value);
+    Serial.print(',');
+    Serial.println(unit);
+}
+
+void setup() {
+    Serial.begin(115200);
+    while (!Serial) {
+        delay(1);
+    }
+
+    OS.addTask(bench, 0x100);
+    for (uint8_t n = 1; n < ARDRTOS_TASK_COUNT; n++) {
+        OS.addTask(helper, (void*)(uintptr_t)n);
+    }
+
+    OS.begin();
+}
+
+/**
+ * @brief changes how many tasks take part, and lets the ones that just stopped get back to waiting.
+ */
+void setActive(uint8_t n) {
+    active = n;
+    for (TaskID t = 1; t < n; t++) {
+        OS.notify(t);
+    }
+    for (uint8_t t = 0; t < ARDRTOS_TASK_COUNT; t++) {
+        OS.yield();
+    }
+}
+
+template<unsigned N>
+void benchQueue() {
+    // static so that the larger ones do not have to fit on the stack of the task
+    static Queue<Bytes<N>, 4> q;
+    static Stack<Bytes<N>, 4> s;
+    Bytes<N> x = {};
+    // the first touch of the storage should not count
+    q.enqueue(x);
+    q.dequeue(x);
+
+    Stamp start = stamp();
+    for (unsigned n = 0; n < ROUNDS; n++) {
+        q.enqueue(x);
+        q.dequeue(x);
+    }
+    report("queue_push_pop", "bytes", N, nsSince(start) / ROUNDS, "ns");
+
+    start = stamp();
+    for (unsigned n = 0; n < ROUNDS; n++) {
+        s.push(x);
+        x = s.pop();
+    }
+    report("stack_push_pop", "bytes", N, nsSince(start) / ROUNDS, "ns");
+}
+
+void bench() {
+    Serial.println("# ArdRTOS benchmark suite");
+    Serial.println("benchmark,parameter,value,unit");
+
+    // every task that is taking part runs once for every yield
+    mode = MODE_YIELD;
+    for (uint8_t tasks = 2; tasks <= ARDRTOS_TASK_COUNT; tasks++) {
+        setActive(tasks);
+        Stamp start = stamp();
+        for (unsigned n = 0; n < ROUNDS; n++) {
+            OS.yield();
+        }
+        report("yield_round_trip", "tasks", tasks, nsSince(start) / ROUNDS, "ns");
+    }
+
+    setActive(1);
+    Stamp start = stamp();
+    for (unsigned n = 0; n < ROUNDS; n++) {
+        lock.lock();
+        lock.unlock();
+    }
+    report("semaphore_free", "tasks", 1, nsSince(start) / ROUNDS, "ns");
+
+    // the helper holds the lock across a yield, so every lock() here has to wait for it
+    mode = MODE_CONTENDED;
+    setActive(2);
+    start = stamp();
+    for (unsigned n = 0; n < ROUNDS; n++) {
+        lock.lock();
+        OS.yield();
+        lock.unlock();
+    }
+    report("semaphore_contended", "tasks", 2, nsSince(start) / ROUNDS, "ns");
+    mode = MODE_YIELD;
+
+    setActive(1);
+    benchQueue<1>();
+    benchQueue<4>();
+    benchQueue<16>();
+    benchQueue<32>();
+
+    // with everyone else busy, the sleeper has to wait for its turn to come back around
+    setActive(ARDRTOS_TASK_COUNT);
+    unsigned long total = 0;
+    unsigned long worst = 0;
+    unsigned long best = 0xFFFFFFFFUL;
+    unsigned long due = millis() + 2;
+    OS.delayUntil(due);
+    unsigned long last = micros();
+    for (unsigned n = 0; n < DELAYS; n++) {
+        due += 2;
+        OS.delayUntil(due);
+        unsigned long now = micros();
+        long off = (long)(now - last) - 2000;
+        unsigned long jitter = off < 0 ? -off : off;
+        last = now;
+        total += jitter;
+        if (jitter > worst) worst = jitter;
+        if (jitter < best) best = jitter;
+    }
+    report("delay_jitter_min", "tasks", ARDRTOS_TASK_COUNT, best, "us");
+    report("delay_jitter_avg", "tasks", ARDRTOS_TASK_COUNT, total / DELAYS, "us");
+    report("delay_jitter_max", "tasks", ARDRTOS_TASK_COUNT, worst, "us");
+
+    Serial.println("# done");
+    Serial.flush();
+    setActive(1);
+#ifdef ARDRTOS_HOST
+    hostEnd();
+#endif
+    for (;;) {
+        OS.delay(1000);
+    }
+}
+
+void helper(void* arg) {
+    uint8_t n = (uintptr_t)arg;
+    if (n >= active) {
+        OS.waitNotify();
+        return;
+    }
+    if (mode == MODE_CONTENDED) {
+        lock.lock();
+        OS.yield();
+        lock.unlock();
+    }
+    // OS.yield() is called right after this by the scheduler
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
@@ -0,0 +1,135 @@
+/**
+ * @file 97_SWITCH_BENCHMARK.cpp
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief measures how many cpu cycles a single context switch takes.
+ * @version 0.1
+ * @date 2022-04-04
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ *
+ *  Purpose:
+ *      Two tasks hand the processor back and forth with OS.yield(). Each one notes the cycle count
+ *      right before it yields, and the other one checks it right after its own yield returns,
+ *      so every sample is exactly one trip through the scheduler and the context switcher.
+ *      To compare against the old setjmp/longjmp switcher, uncomment SETJMP_SWITCH in ArdRTOS.h
+ *      and run this again.
+ *
+ *  Required knowledge:
+ *      Basic c++ programming.
+ *
+ *  Required hardware:
+ *      NONE
+ */
+
+#include <Arduino.h>
+#include "ArdRTOS.h"
+
+// how many switches to average over before each report
+#define SAMPLES 1000
+
+// the cycle count right before the last yield
+volatile unsigned long start;
+
+unsigned long samples = 0;
+unsigned long total = 0;
+unsigned long fastest = 0xFFFFFFFFUL;
+unsigned long slowest = 0;
+
+// yields to the other task over and over, timing each switch
+void pingPong();
+
+/**
+ * @brief reads a free running cycle counter.
+ * timer1 runs at the cpu clock on AVR, and Cortex-M3 and up have one in the DWT.
+ * anything else gets by with micros().
+ */
+static inline unsigned long cycles() {
+#if defined(__AVR__)
+    return TCNT1;
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+    return *(volatile uint32_t*)0xE0001004;
+#else
+    return micros() * clockCyclesPerMicrosecond();
+#endif
+}
+
+void setup() {
+    Serial.begin(115200);
+    while (!Serial) {
+        delay(1);
+    }
+
+#if defined(__AVR__)
+    // no prescaler, so it counts every cycle. a switch is much shorter than 65536 cycles, so rolling over is fine.
+    TCCR1A = 0;
+    TCCR1B = 1 << CS10;
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+    // turn on the trace unit, then its cycle counter
+    *(volatile uint32_t*)0xE000EDFC |= 1UL << 24;
+    *(volatile uint32_t*)0xE0001000 |= 1;
+#endif
+
+    OS.addTask(pingPong);
+    OS.addTask(pingPong);
+
+    OS.begin();
+}
+
+void pingPong() {
+    while (true) {
+        start = cycles();
+        OS.yield();
+#if defined(__AVR__)
+        unsigned long c = (uint16_t)(cycles() - start);
+#else
+        unsigned long c = cycles() - start;
+#endif
+
+        total += c;
+        if (c < fastest) fastest = c;
+        if (c > slowest) slowest = c;
+
+        if (++samples == SAMPLES) {
+#ifdef SETJMP_SWITCH
+            Serial.print("setjmp");
+#else
+            Serial.print("native");
+#endif
+            Serial.print(" cycles/switch min: ");
+            Serial.print(fastest);
+            Serial.print(" avg: ");
+            Serial.print(total / SAMPLES);
+            // interrupts like the one behind millis() land in here too
+            Serial.print(" max: ");
+            Serial.println(slowest);
+            samples = 0;
+            total = 0;
+            fastest = 0xFFFFFFFFUL;
+            slowest = 0;
+        }
+    }
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
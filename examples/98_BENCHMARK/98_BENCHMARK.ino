@@ -0,0 +1,90 @@
+/**
+ * @file 98_BENCHMARK.cpp
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief measures how much of the processor a busy task gets while other tasks sleep.
+ * @version 0.1
+ * @date 2022-04-04
+ * 
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ * 
+ *  Purpose:
+ *      To count how many times per second a busy task gets switched back in while
+ *      every other task is sitting in OS.delay(). Sleeping tasks should cost nothing,
+ *      so the number printed should only drop a little as SLEEPERS goes up.
+ *      Run it on an older release to compare.
+ * 
+ *  Required knowledge:
+ *      Basic c++ programming.
+ *   
+ *  Required hardware:
+ *      NONE
+ */
+
+#include <Arduino.h>
+#include "ArdRTOS.h"
+
+// how many tasks spend their time sleeping. at most ARDRTOS_TASK_COUNT - 1.
+#define SLEEPERS (ARDRTOS_TASK_COUNT - 1)
+
+// how many times the busy task was switched back in since the last report
+volatile unsigned long switches = 0;
+
+// does nothing but yield and count
+void busy();
+// wakes up every 100ms and goes right back to sleep
+void sleeper();
+
+void setup() {
+    Serial.begin(115200);
+    while (!Serial) {
+        delay(1);
+    }
+
+    OS.addTask(busy);
+    for (unsigned char n = 0; n < SLEEPERS; n++) {
+        OS.addTask(sleeper);
+    }
+
+    OS.begin();
+}
+
+void busy() {
+    static unsigned long last = millis();
+
+    switches++;
+    if (millis() - last >= 1000) {
+        last += 1000;
+        Serial.print("switches/s: ");
+        Serial.println(switches);
+        switches = 0;
+    }
+    // OS.yield() is called right after this by the scheduler
+}
+
+void sleeper() {
+    OS.delay(100);
+}
+
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2020 Alex Olson
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
@@ -0,0 +1,233 @@
+/**
+ * @file Arduino.h
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief stands in for the Arduino core so that ArdRTOS can be built for a pc.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ *
+ * time only moves when the program says so, which makes every run of a program exactly the same:
+ *  - every call to millis() or micros() costs a little virtual time, set with hostSetReadCost()
+ *  - hostAdvance() stands in for a task doing real work for that long
+ *  - when every task is asleep, the clock jumps straight to the next one that is due
+ * interrupts are simulated too. they only fire while interrupts are enabled, and never in the middle of the kernel.
+ */
+
+#ifndef __ARDRTOS_HOST_ARDUINO_H__
+#define __ARDRTOS_HOST_ARDUINO_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+// lets the kernel know it is running on a pc
+#define ARDRTOS_HOST
+// code built for a pc needs far more stack than the same code on a microcontroller, so every task gets this much extra
+#define ARDRTOS_HOST_STACK 0x4000
+// how many simulated interrupts can be scheduled at once. delayMicroseconds() takes one of them while a task is sleeping in it.
+#define HOST_INTERRUPT_COUNT 8
+
+#define __ATTR_NORETURN__ __attribute__((noreturn))
+// what the virtual cpu runs at. only used to turn cycles into time.
+#define F_CPU 16000000UL
+#define clockCyclesPerMicrosecond() (F_CPU / 1000000UL)
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+typedef bool boolean;
+typedef uint8_t byte;
+// an interrupt service routine
+typedef void (*HostISR)(void);
+
+void setup();
+void loop();
+
+/*
+##     ## #### ########  ######## ##     ##    ###    ##
+##     ##  ##  ##     ##    ##    ##     ##   ## ##   ##
+##     ##  ##  ##     ##    ##    ##     ##  ##   ##  ##
+##     ##  ##  ########     ##    ##     ## ##     ## ##
+ ##   ##   ##  ##   ##      ##    ##     ## ######### ##
+  ## ##    ##  ##    ##     ##    ##     ## ##     ## ##
+   ###    #### ##     ##    ##     #######  ##     ## ########
+*/
+
+/**
+ * @brief returns the virtual time in microseconds. costs hostSetReadCost() microseconds, and fires any interrupts
+ * that are due if they are enabled.
+ */
+unsigned long micros();
+
+/**
+ * @brief returns the virtual time in milliseconds. costs the same as micros().
+ */
+unsigned long millis();
+
+/**
+ * @brief dissables the simulated interrupts. ones that come due in the meantime fire once they are enabled again.
+ */
+void noInterrupts();
+
+/**
+ * @brief enables the simulated interrupts and fires any that are due.
+ */
+void interrupts();
+
+/**
+ * @brief moves the virtual clock forward, as if the cpu was busy for that long.
+ * interrupts that come due along the way fire at their exact time if they are enabled.
+ *
+ * @param us how long to spend in microseconds
+ */
+void hostAdvance(unsigned long us);
+
+/**
+ * @brief sets how much virtual time each call to millis() or micros() costs. defaults to 1 microsecond.
+ * it has to be more than 0 for tasks that poll the clock without ever sleeping to see any time go by.
+ *
+ * @param us the cost in microseconds
+ */
+void hostSetReadCost(unsigned long us);
+
+/**
+ * @brief makes the program exit once the virtual clock gets to a certain time.
+ * hostEnd() is called when it does.
+ *
+ * @param us the virtual time to stop at in microseconds
+ */
+void hostStopAt(unsigned long us);
+
+/**
+ * @brief called once the virtual clock passes the time given to hostStopAt().
+ * the default exits with 0, so anything registered with atexit() gets to print its results.
+ */
+void hostEnd();
+
+/**
+ * @brief schedules a simulated interrupt.
+ *
+ * @param isr the routine to call. it runs with interrupts dissabled, like any other ISR.
+ * @param at the virtual time to fire at in microseconds
+ * @param period fires again every period microseconds after that. 0 only fires once.
+ * @return uint8_t an id for hostRemoveInterrupt(), or 0xFF if HOST_INTERRUPT_COUNT are already scheduled
+ */
+uint8_t hostAddInterrupt(HostISR isr, unsigned long at, unsigned long period = 0);
+
+/**
+ * @brief stops a simulated interrupt from firing again
+ *
+ * @param id what hostAddInterrupt() returned
+ */
+void hostRemoveInterrupt(uint8_t id);
+
+/**
+ * @brief fires a simulated interrupt right now, or as soon as interrupts are enabled.
+ *
+ * @param isr the routine to call
+ */
+void hostRaise(HostISR isr);
+
+/**
+ * @brief fires whatever was given to attachInterrupt() for an interrupt number, as if the pin changed.
+ *
+ * @param interrupt the interrupt number, as given by digitalPinToInterrupt()
+ */
+void hostTriggerInterrupt(uint8_t interrupt);
+
+/**
+ * @brief returns whether the simulated interrupts are enabled right now
+ */
+bool hostInterruptsEnabled();
+
+/*
+ ######   #######  ########  ########
+##    ## ##     ## ##     ## ##
+##       ##     ## ##     ## ##
+##       ##     ## ########  ######
+##       ##     ## ##   ##   ##
+##    ## ##     ## ##    ##  ##
+ ######   #######  ##     ## ########
+*/
+
+// the rest of the Arduino core, enough for the examples to build. pins just remember what was written to them.
+
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint8_t interrupt, HostISR isr, int mode);
+void detachInterrupt(uint8_t interrupt);
+// seeded the same every run
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+/**
+ * @brief Serial, printed to stdout and read from stdin.
+ */
+class HostSerial {
+public:
+    void begin(unsigned long baud) {}
+    void end() {}
+    operator bool() {return true;}
+    int available();
+    int read();
+    void flush();
+    size_t write(uint8_t c);
+    size_t write(const uint8_t* buf, size_t n);
+    size_t write(const char* s) {return write((const uint8_t*)s, strlen(s));}
+    size_t print(const char* s) {return write(s);}
+    size_t print(char c) {return write((uint8_t)c);}
+    size_t print(long n, int base = DEC);
+    size_t print(unsigned long n, int base = DEC);
+    size_t print(int n, int base = DEC) {return print((long)n, base);}
+    size_t print(unsigned int n, int base = DEC) {return print((unsigned long)n, base);}
+    size_t print(unsigned char n, int base = DEC) {return print((unsigned long)n, base);}
+    size_t print(double n, int digits = 2);
+    size_t println() {return write('\n');}
+    template<typename T> size_t println(T v) {return print(v) + println();}
+    template<typename T> size_t println(T v, int f) {return print(v, f) + println();}
+};
+
+extern HostSerial Serial;
+
+#endif // !__ARDRTOS_HOST_ARDUINO_H__
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
@@ -0,0 +1,388 @@
+/**
+ * @file host.cpp
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief the virtual clock, the simulated interrupts and the rest of the Arduino core for building ArdRTOS on a pc.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ *
+ */
+
+//! INCLUDES BEGIN
+#include "ArdRTOS.h"
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+//! INCLUDES END
+
+HostSerial Serial;
+
+/*
+ ######  ##        #######   ######  ##    ##
+##    ## ##       ##     ## ##    ## ##   ##
+##       ##       ##     ## ##       ##  ##
+##       ##       ##     ## ##       #####
+##       ##       ##     ## ##       ##  ##
+##    ## ##       ##     ## ##    ## ##   ##
+ ######  ########  #######   ######  ##    ##
+*/
+
+// the virtual time in microseconds
+static unsigned long now = 0;
+// what each call to millis() or micros() costs
+static unsigned long readCost = 1;
+// when hostEnd() is called, if stopping is set
+static unsigned long stopTime = 0;
+static bool stopping = false;
+
+// whether the simulated interrupts are enabled
+static bool enabled = true;
+// how many simulated interrupts have fired so far
+static unsigned long fired = 0;
+
+struct HostInterrupt {
+    HostISR isr;
+    unsigned long at;
+    unsigned long period;
+};
+
+// scheduled interrupts. a slot is free when its isr is 0.
+static HostInterrupt scheduled[HOST_INTERRUPT_COUNT];
+// interrupts raised by hostRaise(), waiting for interrupts to be enabled
+static HostISR raised[HOST_INTERRUPT_COUNT];
+static uint8_t raisedCount = 0;
+
+// what attachInterrupt() was given
+static HostISR attached[HOST_INTERRUPT_COUNT];
+
+/**
+ * @brief runs an ISR the way the hardware would, with interrupts dissabled until it returns.
+ */
+static void fire(HostISR isr) {
+    enabled = false;
+    isr();
+    enabled = true;
+    fired++;
+}
+
+/**
+ * @brief finds the scheduled interrupt that is due first
+ *
+ * @return int its slot, or -1 if none are scheduled
+ */
+static int nextScheduled() {
+    int first = -1;
+    for (int i = 0; i < HOST_INTERRUPT_COUNT; i++) {
+        if (scheduled[i].isr != 0 && (first < 0 || (long)(scheduled[i].at - scheduled[first].at) < 0)) {
+            first = i;
+        }
+    }
+    return first;
+}
+
+/**
+ * @brief fires every interrupt that is due if interrupts are enabled, then checks if it is time to stop.
+ */
+static void service() {
+    while (enabled) {
+        if (raisedCount != 0) {
+            HostISR isr = raised[0];
+            raisedCount--;
+            memmove(raised, raised + 1, raisedCount * sizeof(HostISR));
+            fire(isr);
+            continue;
+        }
+        int i = nextScheduled();
+        if (i < 0 || (long)(now - scheduled[i].at) < 0) {
+            break;
+        }
+        HostISR isr = scheduled[i].isr;
+        if (scheduled[i].period != 0) {
+            scheduled[i].at += scheduled[i].period;
+        } else {
+            scheduled[i].isr = 0;
+        }
+        fire(isr);
+    }
+    if (stopping && (long)(now - stopTime) >= 0) {
+        stopping = false;
+        hostEnd();
+    }
+}
+
+unsigned long micros() {
+    now += readCost;
+    service();
+    return now;
+}
+
+unsigned long millis() {
+    return micros() / 1000;
+}
+
+void noInterrupts() {
+    enabled = false;
+}
+
+void interrupts() {
+    enabled = true;
+    service();
+}
+
+bool hostInterruptsEnabled() {
+    return enabled;
+}
+
+void hostAdvance(unsigned long us) {
+    unsigned long target = now + us;
+    // step from one interrupt to the next so that each one fires at exactly its time
+    for (;;) {
+        int i = enabled ? nextScheduled() : -1;
+        if (i < 0 || (long)(target - scheduled[i].at) < 0) {
+            break;
+        }
+        if ((long)(scheduled[i].at - now) > 0) {
+            now = scheduled[i].at;
+        }
+        service();
+    }
+    now = target;
+    service();
+}
+
+void hostSetReadCost(unsigned long us) {
+    readCost = us;
+}
+
+void hostStopAt(unsigned long us) {
+    stopTime = us;
+    stopping = true;
+}
+
+__attribute__((weak)) void hostEnd() {
+    exit(0);
+}
+
+uint8_t hostAddInterrupt(HostISR isr, unsigned long at, unsigned long period) {
+    for (uint8_t i = 0; i < HOST_INTERRUPT_COUNT; i++) {
+        if (scheduled[i].isr == 0) {
+            scheduled[i].isr = isr;
+            scheduled[i].at = at;
+            scheduled[i].period = period;
+            return i;
+        }
+    }
+    return 0xFF;
+}
+
+void hostRemoveInterrupt(uint8_t id) {
+    if (id < HOST_INTERRUPT_COUNT) {
+        scheduled[id].isr = 0;
+    }
+}
+
+void hostRaise(HostISR isr) {
+    if (raisedCount < HOST_INTERRUPT_COUNT) {
+        raised[raisedCount++] = isr;
+    }
+    service();
+}
+
+void hostTriggerInterrupt(uint8_t interrupt) {
+    if (interrupt < HOST_INTERRUPT_COUNT && attached[interrupt] != 0) {
+        hostRaise(attached[interrupt]);
+    }
+}
+
+void osIdle(unsigned long us) {
+    // let anything that is already due go first. it may have made a task ready.
+    unsigned long before = fired;
+    interrupts();
+    if (fired != before) {
+        noInterrupts();
+        return;
+    }
+
+    // then skip straight to whatever happens first: a task being due, an interrupt, or the end.
+    bool forever = us == WAIT_FOREVER;
+    int i = nextScheduled();
+    if (i >= 0 && (forever || (long)(scheduled[i].at - now) < (long)us)) {
+        us = (long)(scheduled[i].at - now) > 0 ? scheduled[i].at - now : 0;
+        forever = false;
+    }
+    if (stopping && (forever || (long)(stopTime - now) < (long)us)) {
+        us = (long)(stopTime - now) > 0 ? stopTime - now : 0;
+        forever = false;
+    }
+    if (forever) {
+        fprintf(stderr, "ArdRTOS host: every task is waiting and nothing is left to wake them up at %lu us\n", now);
+        exit(2);
+    }
+    hostAdvance(us);
+    noInterrupts();
+}
+
+// the scheduled interrupt standing in for the compare match osTimerSet() asks for, or 0xFF when it is off
+static uint8_t timer = 0xFF;
+
+static void timerFired() {
+    // it was a one off, so its slot is already free
+    timer = 0xFF;
+    Scheduler::timerFromISR();
+}
+
+void osTimerSet(unsigned long us) {
+    hostRemoveInterrupt(timer);
+    timer = us == WAIT_FOREVER ? 0xFF : hostAddInterrupt(timerFired, now + us);
+}
+
+/*
+ ######   #######  ########  ########
+##    ## ##     ## ##     ## ##
+##       ##     ## ##     ## ##
+##       ##     ## ########  ######
+##       ##     ## ##   ##   ##
+##    ## ##     ## ##    ##  ##
+ ######   #######  ##     ## ########
+*/
+
+// what has been written to each pin
+static uint8_t pins[256];
+static unsigned long seed = 1;
+
+void delay(unsigned long ms) {
+    hostAdvance(ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+    hostAdvance(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (mode == INPUT_PULLUP) {
+        pins[pin] = HIGH;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    pins[pin] = val != LOW;
+}
+
+int digitalRead(uint8_t pin) {
+    return pins[pin];
+}
+
+void attachInterrupt(uint8_t interrupt, HostISR isr, int mode) {
+    if (interrupt < HOST_INTERRUPT_COUNT) {
+        attached[interrupt] = isr;
+    }
+}
+
+void detachInterrupt(uint8_t interrupt) {
+    if (interrupt < HOST_INTERRUPT_COUNT) {
+        attached[interrupt] = 0;
+    }
+}
+
+void randomSeed(unsigned long s) {
+    seed = s != 0 ? s : 1;
+}
+
+long random(long max) {
+    if (max <= 0) {
+        return 0;
+    }
+    // a plain lcg, so every run sees the same numbers no matter what libc does
+    seed = seed * 1103515245UL + 12345UL;
+    return (long)((seed >> 16) & 0x7FFFFFFFUL) % max;
+}
+
+long random(long min, long max) {
+    return max <= min ? min : min + random(max - min);
+}
+
+int HostSerial::available() {
+    int n = 0;
+    if (ioctl(0, FIONREAD, &n) != 0) {
+        return 0;
+    }
+    return n;
+}
+
+int HostSerial::read() {
+    if (available() == 0) {
+        return -1;
+    }
+    return getchar();
+}
+
+void HostSerial::flush() {
+    fflush(stdout);
+}
+
+size_t HostSerial::write(uint8_t c) {
+    putchar(c);
+    return 1;
+}
+
+size_t HostSerial::write(const uint8_t* buf, size_t n) {
+    return fwrite(buf, 1, n, stdout);
+}
+
+size_t HostSerial::print(long n, int base) {
+    if (base == DEC) {
+        return printf("%ld", n);
+    }
+    return print((unsigned long)n, base);
+}
+
+size_t HostSerial::print(unsigned long n, int base) {
+    char buf[8 * sizeof(long) + 1];
+    char* s = &buf[sizeof(buf) - 1];
+    *s = 0;
+    if (base < 2) {
+        base = DEC;
+    }
+    do {
+        unsigned d = n % base;
+        *--s = d < 10 ? '0' + d : 'A' + d - 10;
+        n /= base;
+    } while (n != 0);
+    return write(s);
+}
+
+size_t HostSerial::print(double n, int digits) {
+    return printf("%.*f", digits, n);
+}
+
+int main() {
+    setup();
+    for (;;) {
+        loop();
+    }
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
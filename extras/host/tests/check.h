@@ -0,0 +1,107 @@
+/**
+ * @file check.h
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief what every test in this folder uses to check its results. make test builds and runs each of them.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ *
+ * a test is a sketch that calls pass() once everything it checks has worked. it fails if a CHECK() does not hold,
+ * if it is still running once the clock gets to TEST_TIME, or if every task ends up waiting on nothing.
+ */
+
+#ifndef __ARDRTOS_HOST_CHECK_H__
+#define __ARDRTOS_HOST_CHECK_H__
+
+//! INCLUDES BEGIN
+#include "ArdRTOS.h"
+#include <stdio.h>
+//! INCLUDES END
+
+// how long a test gets in microseconds of virtual time before it counts as stuck
+#ifndef TEST_TIME
+#define TEST_TIME 10000000UL
+#endif
+
+// fails the test if cond does not hold
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: at %lu us: check failed: %s\n", __FILE__, __LINE__, micros(), #cond); \
+        exit(1); \
+    } \
+} while (0)
+
+// fails the test if the clock is not between from and to milliseconds, counting both
+#define CHECK_AT(from, to) do { \
+    unsigned long _ms = millis(); \
+    if (_ms < (from) || _ms > (to)) { \
+        fprintf(stderr, "%s:%d: expected to be at %lu to %lu ms, but it is %lu ms\n", __FILE__, __LINE__, \
+            (unsigned long)(from), (unsigned long)(to), _ms); \
+        exit(1); \
+    } \
+} while (0)
+
+// a priority as getPriority() reads it, which is always 0 without priorities
+#ifdef NO_PRIORITIES
+#define PRIO(p) 0
+#else
+#define PRIO(p) (p)
+#endif
+
+/**
+ * @brief ends the test once everything has been checked
+ */
+static inline void pass() {
+    exit(0);
+}
+
+/**
+ * @brief ends the test as stuck, since hostStopAt() is only reached if pass() never was
+ */
+void hostEnd() {
+    fprintf(stderr, "still running at %lu us\n", micros());
+    exit(1);
+}
+
+/**
+ * @brief starts the clock on the test. call this in setup().
+ */
+static inline void testBegin() {
+    hostStopAt(TEST_TIME);
+}
+
+/**
+ * @brief sleeps the rest of the test away, for tasks that have nothing left to do
+ */
+static inline void idle() {
+    for (;;) {
+        OS.delay(1000);
+    }
+}
+
+#endif // !__ARDRTOS_HOST_CHECK_H__
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
@@ -0,0 +1,92 @@
+/**
+ * @file countingsemaphore.ino
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief checks that CountingSemaphore counts, times out, and hands a give straight to whoever is waiting.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+//! INCLUDES BEGIN
+#include "check.h"
+//! INCLUDES END
+
+CountingSemaphore<3> sem(2);
+
+// whether the giver could take the count it just gave while the test was waiting on it
+volatile bool stolen = true;
+
+void giveFromISR() {
+    sem.giveFromISR();
+}
+
+void test() {
+    // it starts at 2
+    CHECK(sem.take(0));
+    CHECK(sem.take(0));
+    CHECK(!sem.take(0));
+
+    // and never goes past Max
+    CHECK(sem.give());
+    CHECK(sem.give());
+    CHECK(sem.give());
+    CHECK(!sem.give());
+    CHECK(sem.count() == 3);
+    CHECK(sem.take(0) && sem.take(0) && sem.take(0));
+
+    // nobody gives until 20
+    CHECK(!sem.take(10));
+    CHECK_AT(10, 10);
+
+    // giver gives at 20, then tries to take it back before we get to run
+    CHECK(sem.take(100));
+    CHECK_AT(20, 20);
+    CHECK(!stolen);
+    CHECK(sem.count() == 0);
+
+    // an interrupt gives at 30
+    CHECK(sem.take(100));
+    CHECK_AT(30, 30);
+    CHECK(sem.count() == 0);
+    pass();
+}
+
+void giver() {
+    OS.delayUntil(20);
+    sem.give();
+    stolen = sem.take(0);
+    idle();
+}
+
+void setup() {
+    testBegin();
+    hostAddInterrupt(giveFromISR, 30000);
+    OS.addTask(test);
+    OS.addTask(giver);
+    OS.begin();
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
@@ -0,0 +1,95 @@
+/**
+ * @file eventgroup.ino
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief checks that EventGroup waits time out, wake on the right bits, and wake every waiter at once.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+//! INCLUDES BEGIN
+#include "check.h"
+//! INCLUDES END
+
+EventGroup events;
+
+// what each waiter got when it was woken
+EventBits seen[2];
+
+void test() {
+    // nothing ever sets 0x01
+    CHECK(events.waitAny(0x01, 10) == 0);
+    CHECK_AT(10, 10);
+
+    // setter sets 0x02 at 20
+    CHECK(events.waitAny(0x03, 100) == 0x02);
+    CHECK_AT(20, 20);
+    // bits that are already set do not wait
+    CHECK(events.waitAny(0x02, 0) == 0x02);
+
+    // setter sets 0x04 at 30 and 0x08 at 40, so this is only satisfied at 40. both are cleared once it is.
+    CHECK(events.waitAll(0x0C, 100, true) == 0x0E);
+    CHECK_AT(40, 40);
+    CHECK(events.get() == 0x02);
+
+    // setter sets 0x10 at 50 with both waiters waiting on it
+    OS.delayUntil(60);
+    CHECK(seen[0] == 0x12);
+    CHECK(seen[1] == 0x12);
+    // each waiter asked for 0x10 to be cleared, but only after both of them saw it
+    CHECK(events.get() == 0x02);
+    CHECK(events.clear(0x02) == 0x02);
+    CHECK(events.get() == 0);
+    pass();
+}
+
+void setter() {
+    OS.delayUntil(20);
+    events.set(0x02);
+    OS.delayUntil(30);
+    events.set(0x04);
+    OS.delayUntil(40);
+    events.set(0x08);
+    OS.delayUntil(50);
+    events.set(0x10);
+    idle();
+}
+
+void waiter(void* arg) {
+    *(EventBits*)arg = events.waitAny(0x10, WAIT_FOREVER, true);
+    idle();
+}
+
+void setup() {
+    testBegin();
+    OS.addTask(test);
+    OS.addTask(setter);
+    OS.addTask(waiter, &seen[0]);
+    OS.addTask(waiter, &seen[1]);
+    OS.begin();
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
@@ -0,0 +1,110 @@
+/**
+ * @file messagebuffer.ino
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief checks that MessageBuffer keeps each message whole across the end of the ring, times out, and wakes its reader.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+//! INCLUDES BEGIN
+#include "check.h"
+//! INCLUDES END
+
+MessageBuffer<32> messages;
+
+// the next message the writer sends. message k is k + 1 bytes long and counts up from k.
+uint8_t sent = 0;
+
+bool send(bool fromISR) {
+    uint8_t msg[16];
+    uint8_t n = 1 + sent % 14;
+    for (uint8_t k = 0; k < n; k++) {
+        msg[k] = sent + k;
+    }
+    if (!(fromISR ? messages.writeFromISR(msg, n) : messages.write(msg, n))) {
+        return false;
+    }
+    sent++;
+    return true;
+}
+
+void sendFromISR() {
+    send(true);
+}
+
+void test() {
+    uint8_t buf[16];
+    // nothing is written until 20
+    CHECK(messages.read(buf, sizeof(buf), 10) == 0);
+    CHECK_AT(10, 10);
+    CHECK(messages.nextSize() == 0);
+
+    // an interrupt writes one at 20
+    CHECK(messages.read(buf, sizeof(buf), 100) == 1);
+    CHECK_AT(20, 20);
+    CHECK(buf[0] == 0);
+
+    // nothing longer than half the ring minus its length fits
+    CHECK(!messages.write(buf, 32 / 2));
+    CHECK(!messages.write(buf, 0));
+    CHECK(messages.isEmpty());
+
+    // send and take enough that the messages go around the ring many times, checking each one is whole
+    uint8_t got = 1;
+    for (int round = 0; round < 200; round++) {
+        while (send(false));
+        while (messages.nextSize() != 0) {
+            uint8_t n;
+            const uint8_t* m = messages.front(n);
+            CHECK(m != 0);
+            CHECK(n == 1 + got % 14);
+            for (uint8_t k = 0; k < n; k++) {
+                CHECK(m[k] == (uint8_t)(got + k));
+            }
+            messages.release();
+            got++;
+        }
+    }
+    CHECK(got == sent);
+
+    // a message too long for what the reader has room for is left where it is
+    CHECK(messages.write(buf, 3));
+    CHECK(messages.read(buf, 2) == 0);
+    CHECK(messages.nextSize() == 3);
+    CHECK(messages.read(buf, sizeof(buf)) == 3);
+    CHECK(messages.isEmpty());
+    pass();
+}
+
+void setup() {
+    testBegin();
+    hostAddInterrupt(sendFromISR, 20000);
+    OS.addTask(test);
+    OS.begin();
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
@@ -0,0 +1,111 @@
+/**
+ * @file mutex.ino
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief checks that Mutex times out, nests, lends its owner the priority of whoever is waiting, and hands itself straight to them.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+//! INCLUDES BEGIN
+#include "check.h"
+//! INCLUDES END
+
+Mutex m;
+
+TaskID lowID, highID;
+
+// the order the tasks got to run once low woke back up
+char order[4];
+volatile uint8_t ran = 0;
+
+void low() {
+    lowID = OS.getTaskID();
+    // it can be taken again by its owner without blocking
+    CHECK(m.lockImmediate());
+    CHECK(m.lockImmediate());
+    CHECK(m.getOwner() == lowID);
+
+    // high tries to take it at 5 and gives up at 10, then waits on it for good from 15
+    OS.delayUntil(20);
+    CHECK(OS.getPriority(lowID) == PRIO(3));
+#ifndef NO_PRIORITIES
+    CHECK(m.getInheritCount() == 2);
+#endif
+
+    // low and mid are both due at 30. low has high's priority until it unlocks, so it goes first.
+    // without priorities, they just take turns.
+    OS.delayUntil(30);
+    order[ran++] = 'L';
+    CHECK(m.unlock());
+    CHECK(m.getOwner() == lowID);
+    CHECK(m.unlock());
+    // back to its own priority, and high owns it now without having ran yet
+    CHECK(OS.getPriority(lowID) == PRIO(1));
+    CHECK(m.getOwner() == highID);
+    CHECK(!m.unlock());
+    OS.yield();
+
+    CHECK(ran == 3);
+#ifndef NO_PRIORITIES
+    CHECK(strcmp(order, "LHM") == 0);
+#endif
+    CHECK(m.available());
+    pass();
+}
+
+void mid() {
+    OS.delayUntil(30);
+    order[ran++] = 'M';
+    idle();
+}
+
+void high() {
+    highID = OS.getTaskID();
+    OS.delayUntil(5);
+    CHECK(!m.lockImmediate());
+    CHECK(!m.lock(5));
+    CHECK_AT(10, 10);
+    // low only keeps high's priority while high is waiting
+    CHECK(OS.getPriority(lowID) == PRIO(1));
+
+    OS.delayUntil(15);
+    m.lock();
+    order[ran++] = 'H';
+    CHECK(m.getOwner() == highID);
+    CHECK(m.unlock());
+    idle();
+}
+
+void setup() {
+    testBegin();
+    OS.addTask(low, 0x40, 1);
+    OS.addTask(mid, 0x40, 2);
+    OS.addTask(high, 0x40, 3);
+    OS.begin();
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
@@ -0,0 +1,124 @@
+/**
+ * @file nestedmutex.ino
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief checks that a task holding several Mutexes keeps the priority it is lent until it has released every one with a waiter.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+//! INCLUDES BEGIN
+#include "check.h"
+//! INCLUDES END
+
+Mutex a, b, c;
+
+TaskID lowID, midID, highID;
+
+void low() {
+    lowID = OS.getTaskID();
+
+    // high waits on a from 5. unlocking b first must not drop low while high is still waiting on a.
+    CHECK(a.lockImmediate() && b.lockImmediate());
+    OS.delayUntil(10);
+    CHECK(OS.getPriority(lowID) == PRIO(3));
+    CHECK(b.unlock());
+    CHECK(OS.getPriority(lowID) == PRIO(3));
+    CHECK(a.unlock());
+    CHECK(OS.getPriority(lowID) == PRIO(1));
+    CHECK(a.getOwner() == highID);
+
+    // the same, unlocking them the other way around. high waits on b from 25.
+    OS.delayUntil(20);
+    CHECK(a.lockImmediate() && b.lockImmediate());
+    OS.delayUntil(30);
+    CHECK(a.unlock());
+    CHECK(OS.getPriority(lowID) == PRIO(3));
+    CHECK(b.unlock());
+    CHECK(OS.getPriority(lowID) == PRIO(1));
+
+    // mid waits on a from 45 while it is lent high's priority through c
+    OS.delayUntil(40);
+    CHECK(a.lockImmediate());
+    OS.delayUntil(50);
+    CHECK(OS.getPriority(lowID) == PRIO(3));
+    CHECK(a.unlock());
+    CHECK(OS.getPriority(lowID) == PRIO(1));
+
+    // the owner can lock it 255 times, but no more
+    OS.delayUntil(70);
+    for (int k = 0; k < 255; k++) {
+        CHECK(c.lockImmediate());
+    }
+    CHECK(!c.lockImmediate());
+    for (int k = 0; k < 255; k++) {
+        CHECK(c.unlock());
+    }
+    CHECK(c.available());
+    CHECK(!c.unlock());
+    pass();
+}
+
+void mid() {
+    midID = OS.getTaskID();
+    OS.delayUntil(41);
+    CHECK(c.lockImmediate());
+    OS.delayUntil(45);
+    CHECK(OS.getPriority(midID) == PRIO(3));
+    a.lock();
+    // a was handed over while mid was lent high's priority, which is not what mid goes back to
+    CHECK(OS.getPriority(midID) == PRIO(3));
+    CHECK(c.unlock());
+    CHECK(OS.getPriority(midID) == PRIO(1));
+    CHECK(a.unlock());
+    CHECK(OS.getPriority(midID) == PRIO(1));
+    CHECK(OS.getBasePriority(midID) == PRIO(1));
+    idle();
+}
+
+void high() {
+    highID = OS.getTaskID();
+    OS.delayUntil(5);
+    a.lock();
+    CHECK(a.unlock());
+    OS.delayUntil(25);
+    b.lock();
+    CHECK(b.unlock());
+    OS.delayUntil(43);
+    c.lock();
+    CHECK(c.unlock());
+    idle();
+}
+
+void setup() {
+    testBegin();
+    OS.addTask(low, 0x40, 1);
+    OS.addTask(mid, 0x40, 1);
+    OS.addTask(high, 0x40, 3);
+    OS.begin();
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
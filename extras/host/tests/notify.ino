@@ -0,0 +1,106 @@
+/**
+ * @file notify.ino
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief checks that task notifications count, set bits, overwrite, time out, and come through from interrupts.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+//! INCLUDES BEGIN
+#include "check.h"
+//! INCLUDES END
+
+// the task that gets notified. it is added first.
+#define WAITER 0
+
+void test() {
+    unsigned long v = 123;
+
+    // nothing is sent until 10
+    CHECK(!OS.waitNotify(v, 5));
+    CHECK_AT(5, 5);
+    CHECK(v == 123);
+    CHECK(!OS.waitNotify(0));
+
+    // other notifies it twice at 10, so it wakes once with a count of 2
+    CHECK(OS.waitNotify(v, 100));
+    CHECK_AT(10, 10);
+    CHECK(v == 2);
+
+    // the value starts over once it is taken
+    CHECK(!OS.waitNotify(v, 0));
+
+    // other sets 0x01 at 20, then 0x04 before this gets to run
+    CHECK(OS.waitNotify(v, WAIT_FOREVER));
+    CHECK_AT(20, 20);
+    CHECK(v == 0x05);
+
+    // other overwrites whatever is there at 30
+    CHECK(OS.waitNotify(v, 100));
+    CHECK_AT(30, 30);
+    CHECK(v == 42);
+
+    // one sent while it was not waiting is picked up right away
+    OS.delayUntil(45);
+    CHECK(OS.waitNotify(v, 100));
+    CHECK_AT(45, 45);
+    CHECK(v == 1);
+
+    // the interrupt at 50 wakes it
+    CHECK(OS.waitNotify(100));
+    CHECK_AT(50, 50);
+    pass();
+}
+
+void other() {
+    OS.delayUntil(10);
+    OS.notify(WAITER);
+    OS.notify(WAITER, 0, NOTIFY_INCREMENT);
+    OS.delayUntil(20);
+    OS.notify(WAITER, 0x01, NOTIFY_SET_BITS);
+    OS.notify(WAITER, 0x04, NOTIFY_SET_BITS);
+    OS.delayUntil(30);
+    OS.notify(WAITER, 7, NOTIFY_OVERWRITE);
+    OS.notify(WAITER, 42, NOTIFY_OVERWRITE);
+    OS.delayUntil(40);
+    OS.notify(WAITER);
+    idle();
+}
+
+void interrupt() {
+    OS.notifyFromISR(WAITER);
+}
+
+void setup() {
+    testBegin();
+    hostAddInterrupt(interrupt, 50000);
+    OS.addTask(test);
+    OS.addTask(other);
+    OS.begin();
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
@@ -0,0 +1,105 @@
+/**
+ * @file periodic.ino
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief checks that periodic tasks are released on time, count their overruns, and that too long a period is turned down.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+//! INCLUDES BEGIN
+#include "check.h"
+//! INCLUDES END
+
+// ids in the order the tasks are added
+#define FAST 1
+#define SLOW 2
+
+unsigned long fastAt[8];
+uint8_t fastCount = 0;
+uint8_t slowCount = 0;
+
+// released every 5 ms starting at 2 ms. the fourth release runs for 7 ms, over its deadline.
+void fast() {
+    if (fastCount < 8) {
+        fastAt[fastCount] = micros();
+    }
+    fastCount++;
+    if (fastCount == 4) {
+        hostAdvance(7000);
+    }
+}
+
+// released every 10 ms
+void slow() {
+    slowCount++;
+}
+
+// never added
+void tooSlow() {
+    CHECK(false);
+}
+
+void test() {
+    OS.delayUntil(39);
+    // released at 2, 7, 12, 17, 22, 27, 32, and 37. the one at 17 runs until 24, so the one at 22 starts late.
+    CHECK(fastCount == 8);
+    for (uint8_t i = 0; i < 8; i++) {
+        if (i == 4) {
+            CHECK(fastAt[i] >= 24000 && fastAt[i] <= 24100);
+        } else {
+            CHECK(fastAt[i] >= 2000 + 5000UL * i && fastAt[i] <= 2100 + 5000UL * i);
+        }
+    }
+    // releases are counted as the job finishes, and the one at 37 has finished by now
+    PeriodicStats s = OS.getPeriodicStats(FAST);
+    CHECK(s.releases == 8);
+    CHECK(s.overruns == 1);
+    CHECK(s.worstResponse >= 7000);
+    CHECK(s.maxJitter >= 2000);
+
+    // the ones with too long a period or offset did not take the last periodic slot, so slow got it.
+    // it was released at 0, 10, 20 and 30.
+    CHECK(slowCount == 4);
+    CHECK(OS.getPeriodicStats(SLOW).releases == 4);
+    CHECK(OS.getPeriodicStats(0).releases == 0);
+
+    OS.resetPeriodicStats(FAST);
+    CHECK(OS.getPeriodicStats(FAST).releases == 0);
+    pass();
+}
+
+void setup() {
+    testBegin();
+    OS.addTask(test);
+    OS.addPeriodicTask(fast, 5000, 2000, 0x40, 1);
+    OS.addPeriodicTask(tooSlow, 0x80000000UL);
+    OS.addPeriodicTask(tooSlow, 1000, 0x80000000UL);
+    OS.addPeriodicTask(slow, 10000, 0, 0x40, 1);
+    OS.begin();
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
@@ -0,0 +1,101 @@
+/**
+ * @file pool.ino
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief checks that Pool hands out every block once, times out when it runs dry, wakes whoever is waiting when one is freed, and ignores frees of anything that is not a block in use.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+//! INCLUDES BEGIN
+#include "check.h"
+//! INCLUDES END
+
+Pool<16, 2> pool;
+
+void* a;
+void* b;
+
+void freeFromISR() {
+    pool.freeFromISR(b);
+}
+
+void test() {
+    a = pool.alloc();
+    b = pool.alloc();
+    CHECK(a != 0 && b != 0 && a != b);
+    CHECK(pool.owns(a) && pool.owns(b));
+    CHECK(!pool.owns(&a));
+    CHECK(pool.alloc() == 0);
+    CHECK(pool.used() == 2 && pool.available() == 0);
+
+    // nothing is freed until 20
+    CHECK(pool.alloc(10) == 0);
+    CHECK_AT(10, 10);
+
+    // freer frees a at 20
+    void* p = pool.alloc(100);
+    CHECK_AT(20, 20);
+    CHECK(p == a);
+
+    // an interrupt frees b at 30
+    p = pool.alloc(100);
+    CHECK_AT(30, 30);
+    CHECK(p == b);
+
+    // anything that is not a block in use is ignored
+    pool.free(a);
+    pool.free(0);
+    pool.free(&a);
+    pool.free((uint8_t*)b + 1);
+    CHECK(pool.used() == 1);
+#ifndef NDEBUG
+    // so is a block that is already free
+    pool.free(a);
+    CHECK(pool.used() == 1);
+#endif
+    pool.free(b);
+    CHECK(pool.used() == 0 && pool.available() == 2);
+    CHECK(pool.alloc() != pool.alloc());
+    CHECK(pool.highWater() == 2);
+    pass();
+}
+
+void freer() {
+    OS.delayUntil(20);
+    pool.free(a);
+    idle();
+}
+
+void setup() {
+    testBegin();
+    hostAddInterrupt(freeFromISR, 30000);
+    OS.addTask(test);
+    OS.addTask(freer);
+    OS.begin();
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
@@ -0,0 +1,104 @@
+/**
+ * @file queue.ino
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief checks that Queue keeps order, times out, and wakes readers and writers when an item or a slot shows up.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+//! INCLUDES BEGIN
+#include "check.h"
+//! INCLUDES END
+
+Queue<int, 4> q;
+
+void test() {
+    int x;
+    // nothing is enqueued until 20
+    CHECK(!q.dequeue(x, 10));
+    CHECK_AT(10, 10);
+    CHECK(q.dequeue(x, 100));
+    CHECK_AT(20, 20);
+    CHECK(x == 1);
+
+    // items come out in the order they went in
+    int in[4] = {2, 3, 4, 5};
+    CHECK(q.enqueue(in, 4));
+    CHECK(q.isFull());
+    CHECK(!q.enqueue(6));
+    CHECK(!q.enqueue(6, 10));
+    CHECK_AT(30, 30);
+    CHECK(q.peek(x) && x == 2);
+
+    // reader takes one at 40, which makes room
+    CHECK(q.enqueue(6, 100));
+    CHECK_AT(40, 40);
+
+    int out[4];
+    CHECK(q.dequeue(out, 4) == 4);
+    CHECK(out[0] == 3 && out[1] == 4 && out[2] == 5 && out[3] == 6);
+
+    // waiting for several items only ends once they are all there. writer sends one at 50 and one at 60.
+    CHECK(q.dequeue(out, 2, 100) == 2);
+    CHECK_AT(60, 60);
+    CHECK(out[0] == 7 && out[1] == 8);
+
+    // items can be built and used right inside the queue
+    int* slot = q.reserve();
+    CHECK(slot != 0);
+    *slot = 9;
+    q.commit();
+    const int* item = q.front();
+    CHECK(item != 0 && *item == 9);
+    q.release();
+    CHECK(q.isEmpty());
+    CHECK(q.front(5) == 0);
+    CHECK(q.available());
+    pass();
+}
+
+void other() {
+    OS.delayUntil(20);
+    q.enqueue(1);
+    OS.delayUntil(40);
+    int x;
+    CHECK(q.dequeue(x) && x == 2);
+    OS.delayUntil(50);
+    q.enqueue(7);
+    OS.delayUntil(60);
+    q.enqueue(8);
+    idle();
+}
+
+void setup() {
+    testBegin();
+    OS.addTask(test);
+    OS.addTask(other);
+    OS.begin();
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
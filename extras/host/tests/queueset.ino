@@ -0,0 +1,112 @@
+/**
+ * @file queueset.ino
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief checks that QueueSet times out, wakes on whichever member gets something first, and takes turns between busy ones.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+//! INCLUDES BEGIN
+#include "check.h"
+//! INCLUDES END
+
+Queue<int, 4> q;
+Stack<int, 4> s;
+Semaphore sem;
+QueueSet<3> set;
+
+void test() {
+    CHECK(set.add(q));
+    CHECK(set.add(s));
+    // a member can only be in one set at a time
+    CHECK(!set.add(q));
+    CHECK(set.size() == 2);
+
+    // nothing happens until 20
+    CHECK(set.select(10) == 0);
+    CHECK_AT(10, 10);
+
+    // other pushes onto the stack at 20
+    CHECK(set.select(100) == &s);
+    CHECK_AT(20, 20);
+    CHECK(s.pop() == 1);
+
+    // other enqueues at 30
+    CHECK(set.select(100) == &q);
+    CHECK_AT(30, 30);
+    int x;
+    CHECK(q.dequeue(x) && x == 3);
+
+    // a member is returned for as long as it has something, but busy members take turns
+    q.enqueue(4);
+    q.enqueue(5);
+    s.push(6);
+    void* first = set.select(0);
+    void* second = set.select(0);
+    CHECK(first != second);
+    CHECK(first == &q || first == &s);
+    CHECK(second == &q || second == &s);
+    CHECK(q.dequeue(x) && q.dequeue(x));
+    CHECK(set.select(0) == &s);
+    s.pop();
+
+    // a semaphore is ready while it is unlocked. other holds it from 40 to 50.
+    OS.delayUntil(45);
+    CHECK(set.add(sem));
+    CHECK(set.size() == 3);
+    CHECK(set.select(100) == &sem);
+    CHECK_AT(50, 50);
+    CHECK(sem.lockImmediate());
+    sem.unlock();
+
+    // once removed, a member is never returned
+    CHECK(set.remove(sem));
+    CHECK(!set.remove(sem));
+    CHECK(set.select(5) == 0);
+    pass();
+}
+
+void other() {
+    OS.delayUntil(20);
+    s.push(1);
+    OS.delayUntil(30);
+    q.enqueue(3);
+    OS.delayUntil(40);
+    sem.lock();
+    OS.delayUntil(50);
+    sem.unlock();
+    idle();
+}
+
+void setup() {
+    testBegin();
+    OS.addTask(test);
+    OS.addTask(other);
+    OS.begin();
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
@@ -0,0 +1,105 @@
+/**
+ * @file softtimer.ino
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief checks that SoftTimer goes off on time, once or over and over, and stops and changes period when told to.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+//! INCLUDES BEGIN
+#include "check.h"
+//! INCLUDES END
+
+// how many times each timer went off, and when it last did
+unsigned long onceCount = 0, onceAt = 0;
+unsigned long everyCount = 0, everyAt = 0;
+unsigned long argCount = 0;
+
+void onceFired() {
+    onceCount++;
+    onceAt = millis();
+}
+
+void everyFired() {
+    everyCount++;
+    everyAt = millis();
+}
+
+void argFired(void* arg) {
+    (*(unsigned long*)arg)++;
+}
+
+SoftTimer once(onceFired, 10, false);
+SoftTimer every(everyFired, 5);
+SoftTimer withArg(argFired, &argCount, 4);
+
+void test() {
+    once.start();
+    every.start();
+    withArg.start();
+    CHECK(once.isActive() && every.isActive());
+
+    // checked when no timer is due, since without priorities the timer task does not always run first
+    OS.delayUntil(31);
+    // once went off at 10 and then stopped. every went off at 5, 10, ... 30, and withArg at 4, 8, ... 28.
+    CHECK(onceCount == 1 && onceAt == 10);
+    CHECK(!once.isActive());
+    CHECK(everyCount == 6 && everyAt == 30);
+    CHECK(argCount == 7);
+
+    every.stop();
+    withArg.stop();
+    OS.delayUntil(50);
+    CHECK(everyCount == 6);
+    CHECK(!every.isActive());
+
+    // a new period starts it over from now
+    every.changePeriod(3);
+    CHECK(every.getPeriod() == 3 && every.isActive());
+    OS.delayUntil(57);
+    CHECK(everyCount == 8 && everyAt == 56);
+
+    // starting it again while it is running starts the period over
+    once.start();
+    OS.delayUntil(62);
+    once.start();
+    OS.delayUntil(71);
+    CHECK(onceCount == 1);
+    OS.delayUntil(73);
+    CHECK(onceCount == 2 && onceAt == 72);
+    CHECK(argCount == 7);
+    pass();
+}
+
+void setup() {
+    testBegin();
+    SoftTimer::addTask();
+    OS.addTask(test);
+    OS.begin();
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
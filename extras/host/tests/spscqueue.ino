@@ -0,0 +1,95 @@
+/**
+ * @file spscqueue.ino
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief checks that SpscQueue keeps order, fills up, times out, and wakes its consumer from an interrupt.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+//! INCLUDES BEGIN
+#include "check.h"
+//! INCLUDES END
+
+SpscQueue<int, 4> q;
+int isrValue = 10;
+
+// the producer side, ran as an interrupt at 20 and 30
+void producer() {
+    q.enqueueFromISR(isrValue++);
+}
+
+void test() {
+    int x = 0;
+    CHECK(q.isEmpty());
+    CHECK(!q.dequeue(x));
+    CHECK(!q.dequeue(x, 0));
+
+    // it holds all 4, in order
+    for (int i = 0; i < 4; i++) {
+        CHECK(q.enqueue(i));
+    }
+    CHECK(q.isFull());
+    CHECK(q.size() == 4);
+    CHECK(!q.enqueue(4));
+    for (int i = 0; i < 4; i++) {
+        CHECK(q.dequeue(x) && x == i);
+    }
+    CHECK(q.isEmpty());
+
+    // nothing comes until 20
+    CHECK(!q.dequeue(x, 10));
+    CHECK_AT(10, 10);
+    x = 0;
+
+    // the interrupt wakes it right as it enqueues
+    CHECK(q.dequeue(x, 100));
+    CHECK_AT(20, 20);
+    CHECK(x == 10);
+
+    // something that came in while it was not waiting is handed back right away
+    OS.delayUntil(35);
+    CHECK(q.dequeue(x, 100) && x == 11);
+    CHECK_AT(35, 35);
+
+    // the indexes wrap around without losing anything
+    for (int i = 0; i < 20; i++) {
+        CHECK(q.enqueue(i));
+        CHECK(q.dequeue(x) && x == i);
+    }
+    CHECK(q.isEmpty());
+    pass();
+}
+
+void setup() {
+    testBegin();
+    hostAddInterrupt(producer, 20000);
+    hostAddInterrupt(producer, 30000);
+    OS.addTask(test);
+    OS.begin();
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
@@ -0,0 +1,87 @@
+/**
+ * @file stack.ino
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief checks that Stack comes out backwards, times out, and wakes poppers and pushers when an item or a slot shows up.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+//! INCLUDES BEGIN
+#include "check.h"
+//! INCLUDES END
+
+Stack<int, 2> s;
+
+void test() {
+    // nothing is pushed until 20
+    s.pop(10);
+    CHECK_AT(10, 10);
+    CHECK(s.isEmpty());
+    CHECK(s.pop(100) == 1);
+    CHECK_AT(20, 20);
+
+    // the last one in is the first one out
+    CHECK(s.push(2));
+    CHECK(s.push(3));
+    CHECK(s.top() == 3);
+    CHECK(!s.push(4));
+    CHECK(!s.push(4, 10));
+    CHECK_AT(30, 30);
+
+    // other pops one at 40, which makes room
+    CHECK(s.push(4, 100));
+    CHECK_AT(40, 40);
+    CHECK(s.size() == 2);
+    CHECK(s.pop() == 4);
+    CHECK(s.pop() == 2);
+
+    // clearing it makes room too. other clears it at 50.
+    CHECK(s.push(5) && s.push(6));
+    CHECK(s.push(7, 100));
+    CHECK_AT(50, 50);
+    CHECK(s.size() == 1 && s.top() == 7);
+    pass();
+}
+
+void other() {
+    OS.delayUntil(20);
+    s.push(1);
+    OS.delayUntil(40);
+    CHECK(s.pop() == 3);
+    OS.delayUntil(50);
+    s.clear();
+    idle();
+}
+
+void setup() {
+    testBegin();
+    OS.addTask(test);
+    OS.addTask(other);
+    OS.begin();
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
@@ -0,0 +1,94 @@
+/**
+ * @file streambuffer.ino
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief checks that StreamBuffer only wakes its reader once the trigger level is reached, and hands bytes over in order.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+//! INCLUDES BEGIN
+#include "check.h"
+//! INCLUDES END
+
+StreamBuffer<16> stream(4);
+
+// the next byte the interrupt writes. once the ring is full, it keeps trying the same one.
+uint8_t sent = 0;
+
+void writeFromISR() {
+    sent += stream.writeFromISR(&sent, 1);
+}
+
+void test() {
+    uint8_t buf[16];
+    // an interrupt writes a byte every ms from 20 on. nothing is there before then.
+    CHECK(stream.read(buf, 16, 10) == 0);
+    CHECK_AT(10, 10);
+
+    // the reader is only woken once 4 bytes have come in
+    CHECK(stream.read(buf, 16, 100) == 4);
+    CHECK_AT(23, 23);
+    for (uint8_t k = 0; k < 4; k++) {
+        CHECK(buf[k] == k);
+    }
+
+    // running out of time reads whatever is there
+    stream.setTrigger(16);
+    CHECK(stream.read(buf, 16, 2) == 2);
+    CHECK(buf[0] == 4 && buf[1] == 5);
+
+    // bytes can be used right where they are, and wrap around past the end of the ring
+    OS.delay(20);
+    uint8_t n;
+    uint8_t next = 6;
+    unsigned long total = 0;
+    while (total < 16) {
+        const uint8_t* p = stream.front(n);
+        CHECK(p != 0);
+        for (uint8_t k = 0; k < n; k++) {
+            CHECK(p[k] == next++);
+        }
+        stream.release(n);
+        total += n;
+    }
+    CHECK(!stream.isFull());
+
+    // a task writes only what fits
+    OS.delay(20);
+    CHECK(stream.isFull());
+    CHECK(stream.write(buf, 1) == 0);
+    pass();
+}
+
+void setup() {
+    testBegin();
+    hostAddInterrupt(writeFromISR, 20000, 1000);
+    OS.addTask(test);
+    OS.begin();
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
@@ -0,0 +1,139 @@
+/**
+ * @file trace.ino
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief checks that the trace ring keeps the newest records, counts the lost ones, and records locks and switches.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+//! INCLUDES BEGIN
+#include "check.h"
+//! INCLUDES END
+
+#include "Trace.h"
+
+// a stand in for Serial that keeps whatever is dumped
+struct Sink {
+    uint8_t data[10 + ARDRTOS_TRACE_SIZE * sizeof(TraceRecord)];
+    size_t len;
+
+    size_t write(const uint8_t* buf, size_t n) {
+        CHECK(len + n <= sizeof(data));
+        memcpy(data + len, buf, n);
+        len += n;
+        return n;
+    }
+
+    // dumps everything new, checking the header. returns how many records came with it.
+    uint16_t dump(uint16_t lost) {
+        len = 0;
+        Trace::dump(*this);
+        CHECK(len >= 10);
+        CHECK(memcmp(data, "ARTR", 4) == 0);
+        CHECK(data[4] == TRACE_VERSION);
+        CHECK(data[5] == sizeof(TraceRecord));
+        uint16_t count = data[6] | (data[7] << 8);
+        CHECK((data[8] | (data[9] << 8)) == lost);
+        CHECK(len == 10 + count * sizeof(TraceRecord));
+        return count;
+    }
+
+    TraceRecord record(uint16_t i) {
+        TraceRecord r;
+        memcpy(&r, data + 10 + i * sizeof(TraceRecord), sizeof(r));
+        return r;
+    }
+} sink;
+
+Mutex m;
+
+// finds the first record of an event in the last dump, or returns the count if there is none
+uint16_t find(uint16_t count, uint8_t event, uint16_t from=0) {
+    for (uint16_t i = from; i < count; i++) {
+        if (sink.record(i).event == event) {
+            return i;
+        }
+    }
+    return count;
+}
+
+void test() {
+    // throws away the switches from starting up
+    sink.dump(0);
+
+    // only the newest ARDRTOS_TRACE_SIZE are kept, oldest first
+    for (uint16_t k = 0; k < 100; k++) {
+        TRACE(TRACE_USER, k);
+    }
+    uint16_t count = sink.dump(100 - ARDRTOS_TRACE_SIZE);
+    CHECK(count == ARDRTOS_TRACE_SIZE);
+    for (uint16_t i = 0; i < count; i++) {
+        TraceRecord r = sink.record(i);
+        CHECK(r.event == TRACE_USER);
+        CHECK(r.task == 0);
+        CHECK(r.arg == 100 - ARDRTOS_TRACE_SIZE + i);
+    }
+
+    // nothing new, nothing sent
+    CHECK(sink.dump(0) == 0);
+
+    // locks record the low 16 bits of the address of the mutex
+    m.lock();
+    m.unlock();
+    count = sink.dump(0);
+    CHECK(count == 2);
+    CHECK(sink.record(0).event == TRACE_LOCK);
+    CHECK(sink.record(0).arg == (uint16_t)(uintptr_t)&m);
+    CHECK(sink.record(1).event == TRACE_UNLOCK);
+    CHECK(sink.record(1).arg == (uint16_t)(uintptr_t)&m);
+
+    // giving up the cpu records a switch from this task to the other one and back
+    OS.yield();
+    count = sink.dump(0);
+    uint16_t there = find(count, TRACE_SWITCH);
+    CHECK(there < count);
+    CHECK(sink.record(there).task == 0 && sink.record(there).arg == 1);
+    uint16_t back = find(count, TRACE_SWITCH, there + 1);
+    CHECK(back < count);
+    CHECK(sink.record(back).task == 1 && sink.record(back).arg == 0);
+    pass();
+}
+
+void other() {
+    for (;;) {
+        OS.yield();
+    }
+}
+
+void setup() {
+    testBegin();
+    OS.addTask(test);
+    OS.addTask(other);
+    OS.begin();
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
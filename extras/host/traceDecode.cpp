@@ -0,0 +1,148 @@
+/**
+ * @file traceDecode.cpp
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief turns what Trace::dump() writes into a timeline.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ *
+ * reads a capture of Serial from stdin and prints one line per event:
+ *      stty -F /dev/ttyUSB0 115200 raw && cat /dev/ttyUSB0 | ./tracedecode
+ * anything else the sketch prints is skipped, so dumps can be mixed in with the usual output.
+ * times are in microseconds since the first event, so they keep counting up when micros() rolls over.
+ */
+
+//! INCLUDES BEGIN
+#include "ArdRTOS.h"
+#include <stdio.h>
+//! INCLUDES END
+
+static const char* names[] = {"lost", "switch", "isr", "lock", "unlock", "contend", "push", "pop", "full", "empty"};
+
+/**
+ * @brief reads exactly n bytes from stdin
+ *
+ * @return true got them all
+ * @return false ran out of input
+ */
+static bool readAll(uint8_t* buf, size_t n) {
+    return fread(buf, 1, n, stdin) == n;
+}
+
+/**
+ * @brief skips ahead to the next "ARTR" in the input
+ *
+ * @return true found one
+ * @return false ran out of input
+ */
+static bool findHeader() {
+    const char* magic = "ARTR";
+    int matched = 0;
+    int c;
+    while ((c = getchar()) != EOF) {
+        if (c == magic[matched]) {
+            if (++matched == 4) {
+                return true;
+            }
+        } else {
+            matched = c == magic[0] ? 1 : 0;
+        }
+    }
+    return false;
+}
+
+int main() {
+    bool first = true;
+    uint32_t last = 0;
+    unsigned long long elapsed = 0;
+    unsigned long events = 0;
+    unsigned long lost = 0;
+
+    printf("%12s %4s  %-8s %s\n", "time_us", "task", "event", "arg");
+    while (findHeader()) {
+        uint8_t h[6];
+        if (!readAll(h, sizeof(h))) {
+            break;
+        }
+        if (h[0] != TRACE_VERSION || h[1] != sizeof(TraceRecord)) {
+            fprintf(stderr, "skipping a dump from version %u with %u byte records\n", h[0], h[1]);
+            continue;
+        }
+        unsigned count = h[2] | h[3] << 8;
+        unsigned skipped = h[4] | h[5] << 8;
+        if (skipped != 0) {
+            printf("%12s %4s  %-8s %u records were overwritten before they were dumped\n", "", "", "lost", skipped);
+            lost += skipped;
+        }
+
+        for (unsigned n = 0; n < count; n++) {
+            uint8_t b[sizeof(TraceRecord)];
+            if (!readAll(b, sizeof(b))) {
+                break;
+            }
+            TraceRecord r;
+            r.time = b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 | (uint32_t)b[3] << 24;
+            r.event = b[4];
+            r.task = b[5];
+            r.arg = b[6] | b[7] << 8;
+
+            if (r.event == 0) {
+                lost++;
+                continue;
+            }
+            // adding up the differences keeps the time right across micros() rolling over
+            if (!first) {
+                elapsed += (uint32_t)(r.time - last);
+            }
+            first = false;
+            last = r.time;
+            events++;
+
+            char event[16];
+            if (r.event >= TRACE_USER) {
+                snprintf(event, sizeof(event), "user%u", r.event - TRACE_USER);
+            } else if (r.event < sizeof(names) / sizeof(names[0])) {
+                snprintf(event, sizeof(event), "%s", names[r.event]);
+            } else {
+                snprintf(event, sizeof(event), "?%u", r.event);
+            }
+
+            printf("%12llu %4u  %-8s ", elapsed, r.task, event);
+            if (r.event == TRACE_SWITCH) {
+                printf("-> %u\n", r.arg);
+            } else if (r.event == TRACE_INTERRUPT || r.event >= TRACE_USER) {
+                printf("%u\n", r.arg);
+            } else {
+                // the address of the Semaphore, Mutex, Queue or Stack. look it up in the output of avr-nm.
+                printf("0x%04x\n", r.arg);
+            }
+        }
+    }
+    fprintf(stderr, "%lu events, %lu lost\n", events, lost);
+    return 0;
+}
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
@@ -15,24 +15,54 @@
 //! SETTINGS BEGIN
 // numerical settings 
 #define ARDRTOS_TASK_COUNT 8
+// how many priority levels tasks can be given. at most 8.
+#define ARDRTOS_PRIORITY_COUNT 8
+// how many tasks can be added with addPeriodicTask(). at least 1.
+#define ARDRTOS_PERIODIC_COUNT 2
+// the interrupt that drives PREEMPTIVE. if this is changed, define osTickSetup() to start that interrupt.
+#define ARDRTOS_TICK_VECTOR TIMER0_COMPA_vect
+// how many events TASK_TRACE keeps before overwriting the oldest. must be a power of 2. each one is 8 bytes.
+#define ARDRTOS_TRACE_SIZE 64
 
 // uncomment below to activate or deactivate settings
-//#defined COOP_ONLY
-//#defined NO_PRIORITIES
+//#define COOP_ONLY
+//#define PREEMPTIVE
+//#define NO_PRIORITIES
+//#define NO_STACK_CHECK
+//#define TASK_STATS
+//#define TASK_TRACE
+//#define SETJMP_SWITCH
+// leaves timer2 alone on AVR, so analogWrite() keeps working on its pins (D3 and D11 on an Uno) and tone() can be used.
+// delayMicroseconds() then wakes on the next switch instead of right on time.
+//#define NO_US_TIMER
 //! SETTINGS END
 
+#if defined(COOP_ONLY) && defined(PREEMPTIVE)
+#error "COOP_ONLY and PREEMPTIVE can not both be defined"
+#endif
+
+// AVR and Cortex-M get a hand written context switcher. everything else falls back on setjmp and longjmp.
+#if !defined(__AVR__) && !defined(__ARM_ARCH_6M__) && !defined(__ARM_ARCH_7M__) && !defined(__ARM_ARCH_7EM__) \
+    && !defined(__ARM_ARCH_8M_BASE__) && !defined(__ARM_ARCH_8M_MAIN__)
+#define SETJMP_SWITCH
+#endif
+
 #include <Arduino.h>
 
 typedef void (*osFuncCall)(void);
 typedef void (*osFuncCallArg)(void*);
 typedef unsigned char TaskID;
+// higher numbers run first. 0 is the lowest priority.
+typedef unsigned char Priority;
 
 #define NOOP __attribute__((optimize("O0")))
 
 //! INCLUDES BEGIN
 #include "Scheduler.h"
 extern Scheduler OS;
+#include "Trace.h"
 #include "datatypes/init.h"
+#include "SoftTimer.h"
 //! INCLUDES END
 
 #endif // __ARDRTOS_H__
@@ -25,6 +25,130 @@ Y88b  d88P Y88b  d88P 888    888 888        888  .d88P Y88b. .d88P 888      888
  "Y8888P"   "Y8888P"  888    888 8888888888 8888888P"   "Y88888P"  88888888 8888888888 888   T88b
 */
 
+// marks the end of a list of tasks, or that no task is there at all
+#define NO_TASK 0xFF
+
+// pass as a timeout to wait without one
+#define WAIT_FOREVER 0xFFFFFFFFUL
+
+// what Scheduler::notify() does to the notification value of the task
+typedef unsigned char NotifyAction;
+// or the value into the notification value, so each bit can be its own event
+#define NOTIFY_SET_BITS 0
+// add one to the notification value, so it counts how many times the task was notified. the value given is ignored.
+#define NOTIFY_INCREMENT 1
+// replace the notification value, even if the task has not seen the last one yet
+#define NOTIFY_OVERWRITE 2
+
+// lends priorities through the scheduler. see Signaling.h
+class Mutex;
+
+/**
+ * @brief a list of tasks that are blocked waiting for something, like a Semaphore being unlocked.
+ * the list is threaded through the tasks themselves, so each list only costs one byte.
+ */
+struct WaitList {
+    // the first task in the list
+    TaskID head;
+
+    WaitList() : head(NO_TASK) {};
+
+    /**
+     * @brief returns whether any task is waiting
+     * 
+     * @return true no tasks are waiting
+     * @return false at least one task is waiting
+     */
+    bool isEmpty() {return head == NO_TASK;};
+};
+
+/**
+ * @brief a snapshot of how well a periodic task has kept to its schedule. see Scheduler::getPeriodicStats()
+ */
+struct PeriodicStats {
+    // how many times the task has been released
+    unsigned long releases;
+    // the latest the task has ever started after being released in microseconds
+    unsigned long maxJitter;
+    // the longest from being released to finishing in microseconds
+    unsigned long worstResponse;
+    // how many releases missed their deadline, which is the next release. this counts the ones that were skipped
+    // because the task was still running when their deadline came too.
+    unsigned long overruns;
+};
+
+#ifdef TASK_STATS
+/**
+ * @brief a snapshot of how a single task has been using the processor. see Scheduler::getStats()
+ */
+struct TaskStats {
+    // the total time the task has spent running in microseconds
+    unsigned long runTime;
+    // how many times the task has been switched in
+    unsigned long switches;
+    // the longest the task has ever ran without yielding in microseconds
+    unsigned long longestRun;
+};
+
+/**
+ * @brief a snapshot of what the scheduler as a whole has been doing. see Scheduler::getStats()
+ */
+struct SchedulerStats {
+    // how many times any task has been switched in
+    unsigned long switches;
+    // how long every task was asleep at once in microseconds
+    unsigned long idleTime;
+    // how many times the processor woke up from idle with nothing to run
+    unsigned long spuriousWakeups;
+};
+#endif
+
+/**
+ * @brief called by the scheduler whenever every task is asleep. it is called with interrupts dissabled and 
+ * should enable them, put the processor to sleep for at most us microseconds or until an interrupt happens, 
+ * then dissable interrupts again before returning. waking up early is fine since it will just be called again.
+ * 
+ * a default is provided for AVR and ARM. define your own to use a deeper sleep mode, or to fast forward a virtual clock.
+ * 
+ * @param us how long until the next task is due in microseconds, or WAIT_FOREVER if no task is sleeping
+ */
+void osIdle(unsigned long us);
+
+/**
+ * @brief called whenever the first task sleeping in delayMicroseconds() changes, with interrupts dissabled.
+ * it should arrange for an interrupt that calls Scheduler::timerFromISR() in us microseconds, replacing any set before.
+ * going off early is fine since it will just be set again, but going off late makes the task late.
+ * 
+ * the default on AVR puts timer2 in normal mode and uses its compare match B, so tasks wake within a few microseconds.
+ * timer0 is no use for this, since the core runs it in fast PWM mode, where a new compare value only takes effect
+ * once it overflows, up to a millisecond later. timer2 can no longer do PWM in normal mode, so analogWrite() stops
+ * working on its pins, D3 and D11 on an Uno or Nano and D9 and D10 on a Mega, and tone() cannot be used.
+ * uncomment NO_US_TIMER in ArdRTOS.h to keep timer2. the default then does nothing, as it does off AVR and on parts
+ * without a timer2 like the ATmega32U4 and ATtiny85, and the task wakes the next time any task yields or
+ * the processor idles, which is at most about a millisecond late when nothing else is running.
+ * 
+ * @param us how long until the task is due in microseconds, or WAIT_FOREVER to stop the interrupt
+ */
+void osTimerSet(unsigned long us);
+
+/**
+ * @brief called on a context switch when the canary at the bottom of a tasks stack has been overwritten.
+ * by the time this is called, memory past the end of the stack has already been corrupted.
+ * the default dissables interrupts and halts. define your own to report it.
+ * 
+ * @param t the task that overflowed its stack, or NO_TASK if begin() could not find enough RAM for the stacks
+ */
+void osStackOverflow(TaskID t);
+
+#ifdef PREEMPTIVE
+/**
+ * @brief starts the interrupt in ARDRTOS_TICK_VECTOR. called by begin() with interrupts dissabled.
+ * the default runs a compare match on timer0, which millis() already uses, so it ticks about every millisecond.
+ * define your own if ARDRTOS_TICK_VECTOR is changed to another timer.
+ */
+void osTickSetup();
+#endif
+
 /**
  * @brief This is the main interface with the kernel that most people will interact with. nothing too fancy.
  * 
@@ -42,8 +166,10 @@ public:
      * 
      * @param loop the loop function to use
      * @param stackSize how much memory you are going to use for this task
+     * @param priority tasks with a higher priority always run first. tasks with the same priority take turns.
+     * ignored if NO_PRIORITIES is defined.
      */
-    static void addTask(osFuncCall loop, unsigned stackSize=0x40);
+    static void addTask(osFuncCall loop, unsigned stackSize=0x40, Priority priority=0);
 	
 	/**
      * @brief Create a task to be ran with the given argument. 
@@ -51,11 +177,81 @@ public:
      * @param loop the loop function to use
 	 * @param arg a pointer to the argument to feed the function
      * @param stackSize how much memory you are going to use for this task
+     * @param priority tasks with a higher priority always run first. tasks with the same priority take turns.
+     * ignored if NO_PRIORITIES is defined.
+     */
+    static void addTask(osFuncCallArg loop, void *arg, unsigned stackSize=0x40, Priority priority=0);
+
+	/**
+     * @brief Create a task to be ran on a stack you provide, like a global array. this way every stack shows up in
+     * the RAM usage when compiling instead of being found at run time by begin().
+     * with SETJMP_SWITCH, the array goes unused and begin() carves out a stack of the same size as usual.
+     * 
+     * @param loop the loop function to use
+     * @param stack the array to use as the stack. this includes the room used to save the task when it is switched out.
+     * @param priority tasks with a higher priority always run first. tasks with the same priority take turns.
+     * ignored if NO_PRIORITIES is defined.
+     */
+    template<unsigned N>
+    static void addTask(osFuncCall loop, uint8_t (&stack)[N], Priority priority=0) {addTaskStatic(loop, stack, N, priority);}
+
+	/**
+     * @brief Create a task to be ran with the given argument on a stack you provide, like a global array.
+     * with SETJMP_SWITCH, the array goes unused and begin() carves out a stack of the same size as usual.
+     * 
+     * @param loop the loop function to use
+	 * @param arg a pointer to the argument to feed the function
+     * @param stack the array to use as the stack. this includes the room used to save the task when it is switched out.
+     * @param priority tasks with a higher priority always run first. tasks with the same priority take turns.
+     * ignored if NO_PRIORITIES is defined.
+     */
+    template<unsigned N>
+    static void addTask(osFuncCallArg loop, void *arg, uint8_t (&stack)[N], Priority priority=0) {
+        addTaskStatic((osFuncCall)loop, stack, N, priority);
+        setTaskArg(arg);
+    }
+
+    /**
+     * @brief Create a task that is released every period microseconds. job is called once per release, and the task
+     * sleeps from the time job returns until the next release. releases are kept by the kernel in absolute time,
+     * so they never drift no matter how long job takes. if job is still running at its next release, that counts
+     * as an overrun, and releases that were missed entirely are skipped instead of being ran back to back.
+     * does nothing if ARDRTOS_PERIODIC_COUNT periodic tasks have already been added.
+     *
+     * releases are compared against micros() as a signed difference, so neither periodUs nor offsetUs can be
+     * 2^31 microseconds (about 35.8 minutes) or more. does nothing if either one is. use OS.delay() in a normal task
+     * for anything slower than that.
+     * 
+     * @param job the function to call every release
+     * @param periodUs how often to release the task in microseconds. less than 2^31
+     * @param offsetUs how long after begin() the first release is in microseconds. use this to keep periodic tasks
+     * from all being released at once. less than 2^31
+     * @param stackSize how much memory you are going to use for this task
+     * @param priority tasks with a higher priority always run first. tasks with the same priority take turns.
+     * ignored if NO_PRIORITIES is defined.
+     */
+    static void addPeriodicTask(osFuncCall job, unsigned long periodUs, unsigned long offsetUs=0, unsigned stackSize=0x40, Priority priority=0);
+
+    /**
+     * @brief fetches how well a periodic task has kept to its schedule.
+     * 
+     * @param t the task to fetch the stats of
+     * @return PeriodicStats a copy of the stats. all 0 if t was not added with addPeriodicTask().
+     */
+    static PeriodicStats getPeriodicStats(TaskID t);
+
+    /**
+     * @brief starts the stats of a periodic task over, for measuring a single stretch of time.
+     * 
+     * @param t the task to reset
      */
-    static void addTask(osFuncCallArg loop, void *arg, unsigned stackSize=0x40);
+    static void resetPeriodicStats(TaskID t);
 
     /**
-     * @brief begins ArdRTOS after tasks are assigned
+     * @brief begins ArdRTOS after tasks are assigned. it never returns.
+     * on AVR, stacks that were not handed to addTask() are carved out of the main stack below where begin() was called,
+     * and malloc() is kept below them, so tasks can still use malloc(), new and String. calls osStackOverflow(NO_TASK)
+     * if the heap has already grown into that memory.
      */
     void begin();
 
@@ -66,39 +262,252 @@ public:
 	static void yield();
 
 	/**
-	 * @brief yield until the specified amount of time has passed
+	 * @brief stops the tick from switching tasks until resumePreemption() is called, so that the current task can
+	 * use something that is not threadsafe without being interrupted by another task. interrupts still run.
+	 * calls can be nested. only does anything when PREEMPTIVE is defined.
+	 */
+	static void suspendPreemption();
+
+	/**
+	 * @brief undoes suspendPreemption(). if a tick was skipped in the meantime, this yields.
+	 */
+	static void resumePreemption();
+
+	/**
+	 * @brief yield until the specified amount of time has passed.
+	 * the task is put to sleep and is not switched back in until it is due.
 	 * 
 	 * @param ms how long to wait in milliseconds
 	 */
 	static void delay(unsigned long ms);
 
 	/**
-	 * @brief yield until the specified amount of time has passed
+	 * @brief yield until the specified amount of time has passed.
+	 * the task is put to sleep and is not switched back in until it is due.
 	 * 
-	 * @param ns how long to wait in microseconds
+	 * @param us how long to wait in microseconds
 	 */
 	static void delayMicroseconds(unsigned long us);
 
 	/**
-	 * @brief yield until the specified time
+	 * @brief yield until the specified time. if that time has already passed, this only yields.
 	 * 
 	 * @param ms the time to wait till in milliseconds
 	 */
 	static void delayUntil(unsigned long ms);
 
 	/**
-	 * @brief yield until the specified time
+	 * @brief yield until the specified time. if that time has already passed, this only yields.
 	 * 
-	 * @param ms the time to wait till in microseconds
+	 * @param us the time to wait till in microseconds
 	 */
 	static void delayUntilMicroseconds(unsigned long us);
 
+	/**
+	 * @brief wakes every task whose delayMicroseconds() is up, then sets osTimerSet() for the next one.
+	 * only needed by an osTimerSet() of your own. interrupts must be dissabled before calling this.
+	 */
+	static void timerFromISR();
+
 	/**
 	 * @brief fetches the taskID of the currently running task
 	 * 
 	 * @return uint8_t 
 	 */
 	static TaskID getTaskID();
+
+	/**
+	 * @brief fetches the most stack a task has used so far. use this to trim the stackSize given to addTask().
+	 * 
+	 * @param t the task to check
+	 * @return unsigned the peak stack usage in bytes
+	 */
+	static unsigned getStackHighWater(TaskID t);
+
+#ifdef TASK_STATS
+	/**
+	 * @brief fetches how a task has been using the processor. only available when TASK_STATS is defined.
+	 * 
+	 * @param t the task to fetch the stats of
+	 * @return TaskStats a copy of the tasks stats
+	 */
+	static TaskStats getStats(TaskID t);
+
+	/**
+	 * @brief fetches how many context switches and how much idle time there has been. only available when TASK_STATS is defined.
+	 * 
+	 * @return SchedulerStats a copy of the schedulers stats
+	 */
+	static SchedulerStats getStats();
+
+	/**
+	 * @brief sets every task and scheduler stat back to 0, including the idle time and spurious wakeups.
+	 * only available when TASK_STATS is defined.
+	 */
+	static void resetStats();
+#endif
+
+	/**
+	 * @brief fetches how long the processor has spent in osIdle() because every task was asleep
+	 * 
+	 * @return unsigned long the total idle time in microseconds. this rolls over like micros() does.
+	 */
+	static unsigned long getIdleTime();
+
+	/**
+	 * @brief fetches how many times osIdle() returned without any task being ready to run.
+	 * on AVR, the millis() timer wakes the processor about every millisecond, so long sleeps count up here.
+	 * 
+	 * @return unsigned long the number of spurious wakeups
+	 */
+	static unsigned long getSpuriousWakeups();
+
+	/**
+	 * @brief blocks the current task in the list until it is woken by wake() or runs out of time.
+	 * blocked tasks are not switched to at all, so waiting costs nothing.
+	 * this is used to build things like Semaphore. interrupts must be dissabled before calling this,
+	 * and will be enabled when it returns.
+	 * 
+	 * @param list the list to wait in
+	 * @param timeout how long to wait in milliseconds. WAIT_FOREVER and timeouts over LONG_MAX never run out.
+	 * @return true woken by wake()
+	 * @return false timed out
+	 */
+	static bool wait(WaitList &list, unsigned long timeout=WAIT_FOREVER);
+
+	/**
+	 * @brief wakes the first task waiting in the list. this does not switch to it.
+	 * interrupts must be dissabled before calling this, so it is safe to use inside ISRs.
+	 * 
+	 * @param list the list to wake a task from
+	 * @return TaskID the task that was woken, or NO_TASK if nobody was waiting
+	 */
+	static TaskID wake(WaitList &list);
+
+	/**
+	 * @brief fetches the priority a task is running at right now. this can be higher than the one it was given
+	 * while it holds a Mutex that a higher priority task is waiting on. always 0 if NO_PRIORITIES is defined.
+	 * 
+	 * @param t the task to check
+	 * @return Priority the priority of the task
+	 */
+	static Priority getPriority(TaskID t);
+
+	/**
+	 * @brief fetches the priority a task was given, which is what it runs at whenever no higher priority task
+	 * is waiting on a Mutex it holds. always 0 if NO_PRIORITIES is defined.
+	 * 
+	 * @param t the task to check
+	 * @return Priority the priority the task was given
+	 */
+	static Priority getBasePriority(TaskID t);
+
+	/**
+	 * @brief changes the priority a task was given. while it holds a Mutex that a higher priority task is waiting on,
+	 * it keeps running at that priority until it unlocks. if it is waiting in a WaitList, it moves to its new place in line.
+	 * does nothing if NO_PRIORITIES is defined. interrupts must be dissabled before calling this.
+	 * 
+	 * @param t the task to change
+	 * @param priority the new priority
+	 */
+	static void setPriority(TaskID t, Priority priority);
+
+	/**
+	 * @brief makes a task run at least at a priority until restorePriority() is called for it.
+	 * used by Mutex to lend the priority of a task that is about to wait on it to the owner.
+	 * interrupts must be dissabled before calling this.
+	 * 
+	 * @param t the task to raise
+	 * @param priority the priority to run at, if it is higher than the current one
+	 */
+	static void raisePriority(TaskID t, Priority priority);
+
+	/**
+	 * @brief works the priority a task runs at back out: the highest of the one it was given and that of the first task
+	 * waiting on each Mutex it holds. interrupts must be dissabled before calling this.
+	 * 
+	 * @param t the task to work out
+	 */
+	static void restorePriority(TaskID t);
+
+	/**
+	 * @brief records that a task took a Mutex, so it keeps the priority of whoever waits on it until it is released.
+	 * only for Mutex. interrupts must be dissabled before calling this.
+	 */
+	static void holdMutex(TaskID t, Mutex* m);
+
+	/**
+	 * @brief records that a task gave up a Mutex, and drops it back to whatever priority it is still owed.
+	 * only for Mutex. interrupts must be dissabled before calling this.
+	 */
+	static void releaseMutex(TaskID t, Mutex* m);
+
+	/**
+	 * @brief notifies a task directly. every task has its own notification value, so this needs no Semaphore or
+	 * other object to signal through. if the task is blocked in waitNotify(), it is woken up. this does not switch to it.
+	 * the action always has to be given along with a value, so that notify(t, 0x04) can not be mistaken for sending 0x04.
+	 * 
+	 * @param t the task to notify
+	 * @param value what to apply to the notification value. ignored by NOTIFY_INCREMENT.
+	 * @param action NOTIFY_SET_BITS, NOTIFY_INCREMENT or NOTIFY_OVERWRITE
+	 */
+	static void notify(TaskID t, unsigned long value, NotifyAction action);
+
+	/**
+	 * @brief notifies a task by adding one to its notification value, so it counts how many times it was notified.
+	 * the same as notify(t, 0, NOTIFY_INCREMENT).
+	 * 
+	 * @param t the task to notify
+	 */
+	static void notify(TaskID t);
+
+	/**
+	 * @brief the same as notify(), but for use inside ISRs. interrupts must be dissabled before calling this.
+	 * 
+	 * @param t the task to notify
+	 * @param value what to apply to the notification value. ignored by NOTIFY_INCREMENT.
+	 * @param action NOTIFY_SET_BITS, NOTIFY_INCREMENT or NOTIFY_OVERWRITE
+	 */
+	static void notifyFromISR(TaskID t, unsigned long value, NotifyAction action);
+
+	/**
+	 * @brief the same as notify(t), but for use inside ISRs. interrupts must be dissabled before calling this.
+	 * 
+	 * @param t the task to notify
+	 */
+	static void notifyFromISR(TaskID t);
+
+	/**
+	 * @brief blocks the current task until it is notified. if it was notified since it last checked, this returns right away.
+	 * the notification value is handed back and reset to 0.
+	 * 
+	 * @param value where to put the notification value
+	 * @param timeout how long to wait in milliseconds. WAIT_FOREVER never runs out. there is no default, so that
+	 * waitNotify(t) is never mistaken for this.
+	 * @return true notified
+	 * @return false timed out. value is left alone.
+	 */
+	static bool waitNotify(unsigned long &value, unsigned long timeout);
+
+	/**
+	 * @brief blocks the current task until it is notified, throwing away the notification value.
+	 * 
+	 * @param timeout how long to wait in milliseconds. WAIT_FOREVER never runs out.
+	 * @return true notified
+	 * @return false timed out
+	 */
+	static bool waitNotify(unsigned long timeout=WAIT_FOREVER);
+
+private:
+	/**
+	 * @brief the part of addTask() that does not depend on the size of the array
+	 */
+	static void addTaskStatic(osFuncCall loop, uint8_t* stack, unsigned stackSize, Priority priority);
+
+	/**
+	 * @brief sets the argument of the last task added
+	 */
+	static void setTaskArg(void* arg);
 };
 
 #endif /* SCHEDULER_H_ */
@@ -0,0 +1,135 @@
+/**
+ * @file SoftTimer.h
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief software timers that run their callbacks from a single timer task.
+ * @version 0.1
+ * @date 2022-04-03
+ * 
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+#ifndef SOFTTIMER_H_
+#define SOFTTIMER_H_
+
+/**
+ * @brief calls a function after a period of time, either once or over and over.
+ * every SoftTimer is ran from the same timer task, so small periodic jobs do not each need a task and a stack of their own.
+ * the timer task sleeps until the next timer is due, so it costs nothing in between.
+ * 
+ * callbacks run on the timer task, so they should be short and should not block, or every other timer will be late.
+ * call SoftTimer::addTask() before OS.begin() to create the timer task.
+ */
+class SoftTimer {
+private:
+    // the function to call
+    osFuncCall _fc;
+    // the arg to pass if it exists
+    void* _arg;
+    // how long between calls in milliseconds
+    unsigned long _period;
+    // when the timer is due next in milliseconds. only valid while it is running.
+    unsigned long _expiry;
+    // whether to start over once it goes off
+    bool _reload;
+    // whether it is in the list of running timers
+    bool _running;
+    // the next running timer, due no sooner than this one
+    SoftTimer* _next;
+
+    /**
+     * @brief puts the timer into the list of running timers, keeping it sorted by expiry.
+     * interrupts must be dissabled before calling this.
+     */
+    void insert();
+
+    /**
+     * @brief takes the timer out of the list of running timers.
+     * interrupts must be dissabled before calling this.
+     */
+    void remove();
+
+    /**
+     * @brief the loop of the timer task. calls every timer that is due, then sleeps until the next one is.
+     */
+    static void run();
+public:
+    /**
+     * @brief Construct a new SoftTimer object. it does not run until start() is called.
+     * 
+     * @param callback the function to call
+     * @param period how long between calls in milliseconds
+     * @param autoReload true to call it every period, false to only call it once per start()
+     */
+    SoftTimer(osFuncCall callback, unsigned long period, bool autoReload=true);
+
+    /**
+     * @brief Construct a new SoftTimer object that calls its callback with the given argument. it does not run until start() is called.
+     * 
+     * @param callback the function to call
+     * @param arg a pointer to the argument to feed the function
+     * @param period how long between calls in milliseconds
+     * @param autoReload true to call it every period, false to only call it once per start()
+     */
+    SoftTimer(osFuncCallArg callback, void* arg, unsigned long period, bool autoReload=true);
+
+    /**
+     * @brief creates the task that runs every SoftTimer. call this once before OS.begin().
+     * 
+     * @param stackSize how much memory the callbacks are going to use
+     * @param priority the priority of the timer task. defaults to the highest, so timers are not held up by other tasks.
+     */
+    static void addTask(unsigned stackSize=0x80, Priority priority=ARDRTOS_PRIORITY_COUNT - 1);
+
+    /**
+     * @brief starts the timer so that it goes off one period from now. if it is already running, it starts over.
+     */
+    void start();
+
+    /**
+     * @brief stops the timer. its callback is not called again until start() is.
+     */
+    void stop();
+
+    /**
+     * @brief changes the period and starts the timer over with it
+     * 
+     * @param period how long between calls in milliseconds
+     */
+    void changePeriod(unsigned long period);
+
+    /**
+     * @brief returns whether the timer is running
+     */
+    bool isActive() {return _running;}
+
+    /**
+     * @brief returns the period in milliseconds
+     */
+    unsigned long getPeriod() {return _period;}
+};
+
+#endif /* SOFTTIMER_H_ */
+
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Alex Olson
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
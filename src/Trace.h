@@ -0,0 +1,180 @@
+/**
+ * @file Trace.h
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief records what the kernel and the datatypes are doing into a ring buffer, to be dumped over Serial.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+// what a TraceRecord is about. task is always the task that was running, and arg depends on the event.
+// arg is the task switched to
+#define TRACE_SWITCH 1
+// arg is the number given to TRACE_ISR()
+#define TRACE_INTERRUPT 2
+// arg is the address of the Semaphore or Mutex
+#define TRACE_LOCK 3
+#define TRACE_UNLOCK 4
+// the lock was taken, so the task has to wait for it
+#define TRACE_CONTEND 5
+// arg is the address of the Queue or Stack
+#define TRACE_PUSH 6
+#define TRACE_POP 7
+// a push or pop gave up because there was no room or nothing to take
+#define TRACE_FULL 8
+#define TRACE_EMPTY 9
+// anything from here up is free for users to record with TRACE()
+#define TRACE_USER 32
+
+// bumped whenever the layout of a dump changes
+#define TRACE_VERSION 1
+
+/**
+ * @brief one event. 8 bytes, and dumped exactly as it is in memory, which is little endian on everything supported.
+ */
+struct TraceRecord {
+    // micros() when it happened
+    uint32_t time;
+    // one of the TRACE_ defines
+    uint8_t event;
+    // the task that was running
+    TaskID task;
+    // depends on the event. addresses are cut down to their low 16 bits, which is all of them on AVR.
+    uint16_t arg;
+};
+
+#ifdef TASK_TRACE
+/**
+ * @brief the recorder. every event goes into a ring of ARDRTOS_TRACE_SIZE records, overwriting the oldest.
+ * recording is a call to micros() plus a handful of stores, so it can be left on in the field.
+ *
+ * call Trace::dump(Serial) every so often from a low priority task to stream out whatever is new.
+ * extras/host/traceDecode.cpp turns what it writes into a timeline.
+ */
+class Trace {
+private:
+    static_assert((ARDRTOS_TRACE_SIZE & (ARDRTOS_TRACE_SIZE - 1)) == 0, "ARDRTOS_TRACE_SIZE must be a power of 2");
+    static_assert(sizeof(TraceRecord) == 8, "TraceRecord has to be packed the same on every board");
+
+    // the ring itself
+    static TraceRecord _records[ARDRTOS_TRACE_SIZE];
+    // how many records have ever been written. the newest is just before this.
+    static uint32_t _written;
+    // how many records have been dumped, or skipped because they were overwritten first
+    static uint32_t _sent;
+public:
+    /**
+     * @brief records an event. interrupts must be dissabled before calling this.
+     *
+     * @param event one of the TRACE_ defines, or TRACE_USER and up
+     * @param arg depends on the event
+     */
+    static inline void recordFromISR(uint8_t event, uint16_t arg) {
+        TraceRecord &r = _records[(uint16_t)_written & (ARDRTOS_TRACE_SIZE - 1)];
+        r.time = micros();
+        r.event = event;
+        r.task = Scheduler::getTaskID();
+        r.arg = arg;
+        _written++;
+    }
+
+    /**
+     * @brief records an event.
+     *
+     * @param event one of the TRACE_ defines, or TRACE_USER and up
+     * @param arg depends on the event
+     */
+    static inline void record(uint8_t event, uint16_t arg) {
+        noInterrupts();
+        recordFromISR(event, arg);
+        interrupts();
+    }
+
+    /**
+     * @brief writes every record that has not been dumped yet, oldest first.
+     * anything that was overwritten before it could be dumped is counted as lost.
+     * the dump starts with a small header so that the decoder can find it between other things printed to Serial:
+     * "ARTR", the version, the size of a record, then how many records follow and how many were lost, both 16 bits.
+     *
+     * @param out anything with write(const uint8_t*, size_t), like Serial
+     */
+    template<typename S>
+    static void dump(S &out);
+};
+
+template<typename S>
+void Trace::dump(S &out) {
+    noInterrupts();
+    uint32_t end = _written;
+    uint32_t lost = 0;
+    if (end - _sent > ARDRTOS_TRACE_SIZE) {
+        lost = end - _sent - ARDRTOS_TRACE_SIZE;
+        _sent = end - ARDRTOS_TRACE_SIZE;
+    }
+    interrupts();
+
+    uint16_t count = end - _sent;
+    if (lost > 0xFFFF) {
+        lost = 0xFFFF;
+    }
+    uint8_t header[10] = {'A', 'R', 'T', 'R', TRACE_VERSION, sizeof(TraceRecord),
+        (uint8_t)count, (uint8_t)(count >> 8), (uint8_t)lost, (uint8_t)(lost >> 8)};
+    out.write(header, sizeof(header));
+
+    // events keep coming in while this is being written, so each record is copied out before it can be overwritten.
+    for (; _sent != end; _sent++) {
+        TraceRecord r;
+        noInterrupts();
+        if (_written - _sent > ARDRTOS_TRACE_SIZE) {
+            // it was overwritten already. send it as lost so the count still adds up.
+            r.time = 0;
+            r.event = 0;
+            r.task = NO_TASK;
+            r.arg = 0;
+        } else {
+            r = _records[(uint16_t)_sent & (ARDRTOS_TRACE_SIZE - 1)];
+        }
+        interrupts();
+        out.write((const uint8_t*)&r, sizeof(r));
+    }
+}
+
+#define TRACE(event, arg) Trace::record((event), (uint16_t)(uintptr_t)(arg))
+#define TRACE_FROM_ISR(event, arg) Trace::recordFromISR((event), (uint16_t)(uintptr_t)(arg))
+// put this first thing in an ISR to see it in the trace
+#define TRACE_ISR(n) Trace::recordFromISR(TRACE_INTERRUPT, (n))
+#else
+#define TRACE(event, arg)
+#define TRACE_FROM_ISR(event, arg)
+#define TRACE_ISR(n)
+#endif
+
+#endif // TRACE_H_
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
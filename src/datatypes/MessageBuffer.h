@@ -0,0 +1,243 @@
+/**
+ * @file MessageBuffer.h
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief provides a buffer of variable length messages for handing them from one writer to one reader.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+#ifndef __DATATYPES_MESSAGEBUFFER_H__
+#define __DATATYPES_MESSAGEBUFFER_H__
+
+/**
+ * @brief messages of any length with exactly one writer and one reader, like frames from a radio ISR or lines for a log.
+ * every message is stored as its length followed by its bytes, packed one after another in a single ring,
+ * so a short message only takes up as much room as it needs instead of a whole slot.
+ *
+ * a message is never split around the end of the ring, so the reader can always use one right where it is with front().
+ * when one does not fit before the end, the rest of the ring is skipped and it starts back at the beginning.
+ * so that a message always fits once the reader has caught up, none can be longer than half the ring minus its length.
+ *
+ * the reader can block until a message arrives. the writer never blocks, writing a message that does not fit just fails.
+ *
+ * @tparam Bytes how many bytes it holds, counting the length in front of each message. must be a power of 2.
+ * @tparam IT Generated at compile time. Do not put insert anything into this spot.
+ */
+template<unsigned int Bytes = 64, typename IT = __IT_TYPE__(Bytes)>
+class MessageBuffer : public _ByteRing<Bytes, IT> {
+private:
+    typedef _ByteRing<Bytes, IT> Ring;
+    using Ring::_data;
+    using Ring::_head;
+    using Ring::_tail;
+    using Ring::load;
+    using Ring::store;
+
+    // a length that no message can have. it means the rest of the ring is skipped.
+    static IT skipped() {return (IT)~(IT)0;}
+
+    /**
+     * @brief writes a message at the head, skipping the rest of the ring first if it does not fit before the end.
+     *
+     * @param h where the head is
+     * @param t where the tail is, as far as the writer can tell
+     * @return IT how far the head moves, or 0 if it does not fit
+     */
+    IT put(IT h, IT t, const void* msg, IT n);
+
+    /**
+     * @brief finds the message at the tail, past any part of the ring that was skipped.
+     * there has to be a message waiting.
+     *
+     * @param t where the tail is. moved up to the length of the message.
+     * @return IT how long the message is
+     */
+    IT next(IT &t);
+
+public:
+    /**
+     * @brief Construct a new MessageBuffer object
+     *
+     */
+    MessageBuffer() {};
+
+    /**
+     * @brief used by the writer task to write a message without waiting for anything.
+     * only masks interrupts if the reader has to be woken up.
+     *
+     * @param msg the message
+     * @param n how long it is. 1 up to half of Bytes minus the size of the length
+     * @return true written
+     * @return false there was not room for all of it, so none of it was written
+     */
+    bool write(const void* msg, IT n);
+
+    /**
+     * @brief used by the writer ISR to write a message.
+     * interrupts must already be dissabled, which they are inside an ISR.
+     *
+     * @param msg the message
+     * @param n how long it is. 1 up to half of Bytes minus the size of the length
+     * @return true written
+     * @return false there was not room for all of it, so none of it was written
+     */
+    bool writeFromISR(const void* msg, IT n);
+
+    /**
+     * @brief returns how long the next message is without taking it, or 0 if there are none.
+     */
+    IT nextSize();
+
+    /**
+     * @brief takes the next message, blocking until one arrives.
+     *
+     * @param dst where to put the message
+     * @param max how much room there is. a longer message is left where it is, so check nextSize() first if unsure.
+     * @param timeout how long to wait in milliseconds. 0 does not wait, and WAIT_FOREVER never runs out.
+     * @return IT how long the message was, or 0 if it timed out or did not fit
+     */
+    IT read(void* dst, IT max, unsigned long timeout = 0);
+
+    /**
+     * @brief gets the next message so the reader can use it right where it is instead of copying it out.
+     * nothing is taken until release() is called.
+     *
+     * @param n set to how long the message is
+     * @param timeout how long to wait in milliseconds. 0 does not wait, and WAIT_FOREVER never runs out.
+     * @return const uint8_t* the message, or 0 if it timed out
+     */
+    const uint8_t* front(IT &n, unsigned long timeout = 0);
+
+    /**
+     * @brief takes the message from front() off of the buffer so the writer can reuse its space.
+     */
+    void release();
+};
+
+template<unsigned int Bytes, typename IT>
+IT MessageBuffer<Bytes, IT>::put(IT h, IT t, const void* msg, IT n) {
+    // past this, the part skipped at the end and the message itself could need more than the whole ring
+    if (n == 0 || n > Bytes / 2 - sizeof(IT))
+        return 0;
+    IT pos = h & (Bytes - 1);
+    IT need = sizeof(IT) + n;
+    IT skip = Bytes - pos < need ? Bytes - pos : 0;
+    if ((unsigned long)skip + need > Bytes - (IT)(h - t))
+        return 0;
+    if (skip >= sizeof(IT)) {
+        // anything shorter than a length is skipped without saying so
+        IT s = skipped();
+        memcpy(&_data[pos], &s, sizeof(IT));
+    }
+    pos = (h + skip) & (Bytes - 1);
+    memcpy(&_data[pos], &n, sizeof(IT));
+    memcpy(&_data[pos + sizeof(IT)], msg, n);
+    return skip + need;
+}
+
+template<unsigned int Bytes, typename IT>
+IT MessageBuffer<Bytes, IT>::next(IT &t) {
+    IT pos = t & (Bytes - 1);
+    IT n = skipped();
+    if (Bytes - pos >= sizeof(IT)) {
+        memcpy(&n, &_data[pos], sizeof(IT));
+    }
+    if (n == skipped()) {
+        t += Bytes - pos;
+        memcpy(&n, &_data[0], sizeof(IT));
+    }
+    return n;
+}
+
+template<unsigned int Bytes, typename IT>
+bool MessageBuffer<Bytes, IT>::writeFromISR(const void* msg, IT n) {
+    IT h = _head;
+    IT moved = put(h, _tail, msg, n);
+    if (moved == 0)
+        return false;
+    __asm__ __volatile__ ("" ::: "memory");
+    _head = h + moved;
+    this->wakeReader();
+    return true;
+}
+
+template<unsigned int Bytes, typename IT>
+bool MessageBuffer<Bytes, IT>::write(const void* msg, IT n) {
+    IT h = _head;
+    IT moved = put(h, load(_tail), msg, n);
+    if (moved == 0)
+        return false;
+    store(_head, h + moved);
+    if (!this->_reader.isEmpty()) {
+        noInterrupts();
+        this->wakeReader();
+        interrupts();
+    }
+    return true;
+}
+
+template<unsigned int Bytes, typename IT>
+IT MessageBuffer<Bytes, IT>::nextSize() {
+    IT t = _tail;
+    if (load(_head) == t)
+        return 0;
+    return next(t);
+}
+
+template<unsigned int Bytes, typename IT>
+IT MessageBuffer<Bytes, IT>::read(void* dst, IT max, unsigned long timeout) {
+    IT n;
+    const uint8_t* msg = front(n, timeout);
+    if (msg == 0 || n > max)
+        return 0;
+    memcpy(dst, msg, n);
+    release();
+    return n;
+}
+
+template<unsigned int Bytes, typename IT>
+const uint8_t* MessageBuffer<Bytes, IT>::front(IT &n, unsigned long timeout) {
+    n = 0;
+    if (!this->waitFor(1, timeout))
+        return 0;
+    IT t = _tail;
+    n = next(t);
+    return &_data[(t + sizeof(IT)) & (Bytes - 1)];
+}
+
+template<unsigned int Bytes, typename IT>
+void MessageBuffer<Bytes, IT>::release() {
+    IT t = _tail;
+    if (load(_head) == t)
+        return;
+    IT n = next(t);
+    store(_tail, t + sizeof(IT) + n);
+}
+
+#endif // !__DATATYPES_MESSAGEBUFFER_H__
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
@@ -0,0 +1,207 @@
+/**
+ * @file Pool.h
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief provides a fixed block memory pool for users.
+ * @version 0.1
+ * @date 2022-04-03
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+#ifndef __DATATYPES_POOL_H__
+#define __DATATYPES_POOL_H__
+
+/**
+ * @brief a pool of Count blocks that are BlockSize bytes each. allocating and freeing a block is always the same
+ * small amount of work, and since every block is the same size, the pool can never fragment.
+ * free blocks are kept in a list threaded through the blocks themselves, so the only overhead is a pointer and the counters.
+ *
+ * use the FromISR versions inside of ISRs. tasks can also wait for a block to be freed.
+ *
+ * @tparam BlockSize how many bytes each block holds
+ * @tparam Count how many blocks are in the pool
+ * @tparam IT Generated at compile time. Do not put insert anything into this spot.
+ */
+template<unsigned int BlockSize, unsigned int Count, typename IT = __IT_TYPE__(Count)>
+class Pool {
+private:
+    // a free block holds the next free block. aligned for whatever type the user wants to put in it.
+    union __attribute__((aligned)) Block {
+        Block* next;
+        uint8_t data[BlockSize];
+    };
+
+    Block _blocks[Count];   /** where the data is actually stored */
+    Block* _free;           /** the first free block, or 0 if every block is in use */
+    IT _used;               /** how many blocks are in use */
+    IT _highWater;          /** the most blocks that have ever been in use at once */
+    WaitList _waiters;      /** the tasks waiting for a block to be freed */
+public:
+    /**
+     * @brief Construct a new Pool object with every block free
+     *
+     */
+    Pool();
+
+    /**
+     * @brief grabs a free block without waiting for anything. interrupts must be dissabled before calling this.
+     *
+     * @return void* the block, or 0 if every block is in use
+     */
+    void* allocFromISR();
+
+    /**
+     * @brief grabs a free block without waiting for anything.
+     *
+     * @return void* the block, or 0 if every block is in use
+     */
+    void* alloc();
+
+    /**
+     * @brief grabs a free block, waiting for one to be freed if every block is in use.
+     *
+     * @param timeout how long to wait in milliseconds. WAIT_FOREVER never runs out.
+     * @return void* the block, or 0 if none was freed in time
+     */
+    void* alloc(unsigned long timeout);
+
+    /**
+     * @brief gives a block back to the pool and wakes a task waiting for one.
+     * interrupts must be dissabled before calling this.
+     * does nothing if p is 0 or is not the start of one of this pools blocks. unless NDEBUG is defined, it also
+     * does nothing if the block is already free, which walks the free list.
+     *
+     * @param p a block from this pool
+     */
+    void freeFromISR(void* p);
+
+    /**
+     * @brief gives a block back to the pool and wakes a task waiting for one.
+     * ignores the same pointers freeFromISR() does.
+     *
+     * @param p a block from this pool
+     */
+    void free(void* p);
+
+    /**
+     * @brief returns how many blocks are in use right now
+     */
+    IT used() {return _used;}
+
+    /**
+     * @brief returns the most blocks that have ever been in use at once. use this to trim Count.
+     */
+    IT highWater() {return _highWater;}
+
+    /**
+     * @brief returns how many blocks are free right now
+     */
+    IT available() {return Count - _used;}
+
+    /**
+     * @brief returns whether a pointer is one of this pools blocks
+     *
+     * @param p the pointer to check
+     */
+    bool owns(const void* p) {return p >= (const void*)&_blocks[0] && p < (const void*)&_blocks[Count];}
+};
+
+template<unsigned int BlockSize, unsigned int Count, typename IT>
+Pool<BlockSize, Count, IT>::Pool(): _used(0), _highWater(0) {
+    for (unsigned int n = 0; n < Count - 1; n++) {
+        _blocks[n].next = &_blocks[n + 1];
+    }
+    _blocks[Count - 1].next = 0;
+    _free = &_blocks[0];
+}
+
+template<unsigned int BlockSize, unsigned int Count, typename IT>
+void* Pool<BlockSize, Count, IT>::allocFromISR() {
+    Block* b = _free;
+    if (b == 0)
+        return 0;
+    _free = b->next;
+    if (++_used > _highWater)
+        _highWater = _used;
+    return b;
+}
+
+template<unsigned int BlockSize, unsigned int Count, typename IT>
+void* Pool<BlockSize, Count, IT>::alloc() {
+    noInterrupts();
+    void* p = allocFromISR();
+    interrupts();
+    return p;
+}
+
+template<unsigned int BlockSize, unsigned int Count, typename IT>
+void* Pool<BlockSize, Count, IT>::alloc(unsigned long timeout) {
+    unsigned long start = millis();
+    for (;;) {
+        noInterrupts();
+        void* p = allocFromISR();
+        if (p != 0) {
+            interrupts();
+            return p;
+        }
+        unsigned long waited = millis() - start;
+        if (waited >= timeout) {
+            interrupts();
+            return 0;
+        }
+        // an ISR may grab the block that wakes us before we get to it, so check again either way
+        OS.wait(_waiters, timeout - waited);
+    }
+}
+
+template<unsigned int BlockSize, unsigned int Count, typename IT>
+void Pool<BlockSize, Count, IT>::freeFromISR(void* p) {
+    // 0 is never one of the blocks, so freeing it does nothing like it does with ::free()
+    if (!owns(p) || ((uint8_t*)p - (uint8_t*)_blocks) % sizeof(Block) != 0)
+        return;
+    Block* b = (Block*)p;
+#ifndef NDEBUG
+    // a block that went on the list twice would be handed out twice, and _used would wrap around
+    for (Block* f = _free; f != 0; f = f->next) {
+        if (f == b)
+            return;
+    }
+#endif
+    b->next = _free;
+    _free = b;
+    _used--;
+    OS.wake(_waiters);
+}
+
+template<unsigned int BlockSize, unsigned int Count, typename IT>
+void Pool<BlockSize, Count, IT>::free(void* p) {
+    noInterrupts();
+    freeFromISR(p);
+    interrupts();
+}
+
+#endif // !__DATATYPES_POOL_H__
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
\ No newline at end of file
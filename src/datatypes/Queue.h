@@ -26,6 +26,10 @@ private:
     L _m;                      /** the locking device used to threadsafe the queue */
     T _data[i];                 /** where the data is actually stored */
     IT _front, _back, _count;   /** one of the counters used in opperation */
+    WaitList _readable;         /** tasks waiting for items to be enqueued */
+    WaitList _writable;         /** tasks waiting for items to be dequeued */
+    _QueueSet* _set;            /** the QueueSet this is in, or 0 */
+    friend class _QueueSet;
 
     /**
      * @brief essentially n++ but wraps around i
@@ -34,6 +38,38 @@ private:
      * @return IT returns n before incrementing
      */
     IT next(IT &n);
+
+    /**
+     * @brief whether there is enough data or space to go ahead
+     * 
+     * @param space true to check for free slots, false to check for items
+     * @param n how many are needed
+     */
+    bool ready(bool space, IT n) {return space ? (IT)(i - _count) >= n : _count >= n;}
+
+    /**
+     * @brief blocks until ready(space, n) or the timeout runs out. must be called with the lock held, and returns with it held.
+     * the lock is given up while waiting so that other tasks can get to the queue.
+     * 
+     * @param space true to wait for free slots, false to wait for items
+     * @param n how many are needed
+     * @param timeout how long to wait in milliseconds
+     * @return true ready
+     * @return false timed out
+     */
+    bool waitFor(bool space, IT n, uint64_t timeout);
+
+    /**
+     * @brief wakes every task in the list so they can check whether they can go ahead.
+     * 
+     * @param list the list to wake
+     */
+    void wakeAll(WaitList &list);
+
+    /**
+     * @brief wakes every task waiting for items, and tells the QueueSet this is in that there is one.
+     */
+    void wakeReaders();
 public:
     /**
      * @brief Construct a new Queue object
@@ -48,7 +84,7 @@ public:
      * @return true successfull queueing
      * @return false failure queueing
      */
-    bool enqueue(const T inp);
+    bool enqueue(const T &inp);
     /**
      * @brief used to enqueue another item at the end of the queue
      * 
@@ -57,7 +93,28 @@ public:
      * @return true successfull queueing
      * @return false failure queueing
      */
-    bool enqueue(const T inp, uint64_t timeout);
+    bool enqueue(const T &inp, uint64_t timeout);
+
+    /**
+     * @brief enqueues n items at once without waiting for anything. the lock is only taken once,
+     * and the items are copied in at most two blocks.
+     * 
+     * @param src the items to push onto the end of the queue
+     * @param n how many items there are
+     * @return true every item was queued
+     * @return false there was not room for all of them, so none were queued
+     */
+    bool enqueue(const T* src, IT n);
+    /**
+     * @brief enqueues n items at once, waiting until there is room for all of them.
+     * 
+     * @param src the items to push onto the end of the queue
+     * @param n how many items there are
+     * @param timeout how long to wait before returning failure
+     * @return true every item was queued
+     * @return false there was not room for all of them in time, so none were queued
+     */
+    bool enqueue(const T* src, IT n, uint64_t timeout);
 
     /**
      * @brief Take an item off of the queue. 
@@ -75,8 +132,81 @@ public:
      */
     T dequeue(uint64_t timeout);
 
+    /**
+     * @brief Take an item off of the queue. 
+     * 
+     * @param out where to put the item dequeued
+     * @return true an item was dequeued
+     * @return false the queue was empty. out is left alone.
+     */
+    bool dequeue(T &out);
+    /**
+     * @brief Take an item off of the queue, waiting for one to be enqueued if it is empty.
+     * 
+     * @param out where to put the item dequeued
+     * @param timeout how long to wait for an item
+     * @return true an item was dequeued
+     * @return false timed out. out is left alone.
+     */
+    bool dequeue(T &out, uint64_t timeout);
+
+    /**
+     * @brief takes up to n items off of the queue without waiting for anything. the lock is only taken once,
+     * and the items are copied out in at most two blocks.
+     * 
+     * @param dst where to put the items
+     * @param n the most items to take
+     * @return IT how many items were taken
+     */
+    IT dequeue(T* dst, IT n);
+    /**
+     * @brief waits until there are at least n items in the queue, then takes n of them.
+     * if the timeout runs out first, whatever is there is taken instead.
+     * 
+     * @param dst where to put the items
+     * @param n the most items to take
+     * @param timeout how long to wait for n items
+     * @return IT how many items were taken
+     */
+    IT dequeue(T* dst, IT n, uint64_t timeout);
+
     T peek() {LockGuard l(_m); return _data[_back];}
 
+    /**
+     * @brief copies the item at the front of the queue without taking it off.
+     * 
+     * @param out where to put the item
+     * @return true there was an item to copy
+     * @return false the queue was empty. out is left alone.
+     */
+    bool peek(T &out);
+
+    /**
+     * @brief gets the next free slot so the producer can build an item right inside the queue instead of copying it in.
+     * on success the queue stays locked until commit() is called, which has to happen before anything else touches it.
+     * 
+     * @param timeout how long to wait for a free slot. defaults to not waiting.
+     * @return T* the slot to fill in, or 0 if the queue stayed full. the queue is not left locked on failure.
+     */
+    T* reserve(uint64_t timeout=0);
+    /**
+     * @brief puts the slot from reserve() at the end of the queue and unlocks the queue.
+     */
+    void commit();
+
+    /**
+     * @brief gets the item at the front of the queue so the consumer can use it right where it is instead of copying it out.
+     * on success the queue stays locked until release() is called, which has to happen before anything else touches it.
+     * 
+     * @param timeout how long to wait for an item. defaults to not waiting.
+     * @return const T* the item at the front, or 0 if the queue stayed empty. the queue is not left locked on failure.
+     */
+    const T* front(uint64_t timeout=0);
+    /**
+     * @brief takes the item from front() off of the queue and unlocks the queue.
+     */
+    void release();
+
     IT size() {return _count;}
     bool isEmpty() {return _count == 0;}
     bool isFull() {return _count == i;}
@@ -93,83 +223,230 @@ public:
 
 template<typename T, unsigned int i, typename L, typename IT>
 IT Queue<T, i, L, IT>::next(IT &n) {
+    IT o = n;
     n++;
     if (n >= i) { 
         n = 0;
-        return i;
     }
-    return n-1;
+    return o;
+}
+
+template<typename T, unsigned int i, typename L, typename IT>
+bool Queue<T, i, L, IT>::waitFor(bool space, IT n, uint64_t timeout) {
+    unsigned long start = millis();
+    while (!ready(space, n)) {
+        unsigned long waited = millis() - start;
+        if (waited >= timeout) {
+            return false;
+        }
+        _m.unlock();
+        // nothing can change the queue while interrupts are off, so nothing is missed between checking and waiting
+        noInterrupts();
+        if (!ready(space, n)) {
+            OS.wait(space ? _writable : _readable, timeout > WAIT_FOREVER ? WAIT_FOREVER : (unsigned long)(timeout - waited));
+        } else {
+            interrupts();
+        }
+        _m.lock();
+    }
+    return true;
+}
+
+template<typename T, unsigned int i, typename L, typename IT>
+void Queue<T, i, L, IT>::wakeAll(WaitList &list) {
+    if (list.isEmpty())
+        return;
+    noInterrupts();
+    while (OS.wake(list) != NO_TASK);
+    interrupts();
+}
+
+template<typename T, unsigned int i, typename L, typename IT>
+void Queue<T, i, L, IT>::wakeReaders() {
+    if (_readable.isEmpty() && _set == 0)
+        return;
+    noInterrupts();
+    while (OS.wake(_readable) != NO_TASK);
+    if (_set != 0) {
+        _set->notifyFromISR();
+    }
+    interrupts();
 }
 
 template<typename T, unsigned int i, typename L, typename IT>
-Queue<T, i, L, IT>::Queue(): _front(0), _back(0), _count(0) {};
+Queue<T, i, L, IT>::Queue(): _front(0), _back(0), _count(0), _set(0) {};
 
 template<typename T, unsigned int i, typename L, typename IT>
-bool Queue<T, i, L, IT>::enqueue(const T inp) {
+bool Queue<T, i, L, IT>::enqueue(const T &inp) {
     LockGuard l(_m);
-    if (isFull())
+    if (isFull()) {
+        TRACE(TRACE_FULL, this);
         return false;
+    }
     _data[next(_front)] = inp;
+    _count++;
+    TRACE(TRACE_PUSH, this);
+    wakeReaders();
     return true;
 }
 
 template<typename T, unsigned int i, typename L, typename IT>
-bool Queue<T, i, L, IT>::enqueue(const T inp, uint64_t timeout) {
-    timeout += millis();
-    while(!_m.lockImmediate() && timeout < millis()) {
-        OS.yield();
+bool Queue<T, i, L, IT>::enqueue(const T &inp, uint64_t timeout) {
+    LockGuard l(_m);
+    if (!waitFor(true, 1, timeout)) {
+        TRACE(TRACE_FULL, this);
+        return false;
     }
+    _data[next(_front)] = inp;
+    _count++;
+    TRACE(TRACE_PUSH, this);
+    wakeReaders();
+    return true;
+}
 
-    while (isFull() && timeout < millis()) {
-        _m.unlock();
-        OS.yield();
-        while(!_m.lockImmediate() && timeout < millis()) {
-            OS.yield();
-        }
-    }
+template<typename T, unsigned int i, typename L, typename IT>
+bool Queue<T, i, L, IT>::enqueue(const T* src, IT n) {
+    return enqueue(src, n, 0);
+}
 
-    if (isFull()) {
-        _m.unlock();
+template<typename T, unsigned int i, typename L, typename IT>
+bool Queue<T, i, L, IT>::enqueue(const T* src, IT n, uint64_t timeout) {
+    if (n > i)
         return false;
-    } else if (timeout < millis()) {
-        // we dont have a lock anyways.
+    LockGuard l(_m);
+    if (!waitFor(true, n, timeout)) {
+        TRACE(TRACE_FULL, this);
         return false;
-    } else {
-        _data[next(_front)] = inp;
-        _m.unlock();
-        return true;
     }
+    // the first block runs up to the end of _data, the rest wraps around to the start
+    IT first = i - _front < n ? i - _front : n;
+    __DATATYPES__HELPER__::copy(&_data[_front], src, first);
+    __DATATYPES__HELPER__::copy(&_data[0], src + first, n - first);
+    _front = _front + n >= i ? _front + n - i : _front + n;
+    _count += n;
+    TRACE(TRACE_PUSH, this);
+    wakeReaders();
+    return true;
 }
 
 template<typename T, unsigned int i, typename L, typename IT>
 T Queue<T, i, L, IT>::dequeue() {
     LockGuard l(_m);
-    if (isEmpty())
+    if (isEmpty()) {
+        TRACE(TRACE_EMPTY, this);
         return _data[_back];
+    }
+    _count--;
+    TRACE(TRACE_POP, this);
+    wakeAll(_writable);
     return _data[next(_back)];
 }
 
 template<typename T, unsigned int i, typename L, typename IT>
 T Queue<T, i, L, IT>::dequeue(uint64_t timeout) {
-    timeout += millis();
-    while(!_m.lockImmediate() && timeout < millis()) {
-        OS.yield();
-    }
-    while (isFull() && timeout < millis()){
-        _m.unlock();
-        OS.yield();
-        // while we dont have the lock, and we are still within timeout...
-        while(!_m.lockImmediate() && timeout < millis()){
-            OS.yield();
-        }
-    }
     // this will call the deconstructor, unlocking it when we return.
     LockGuard l(_m);
-    if (isEmpty())
+    if (!waitFor(false, 1, timeout)) {
+        TRACE(TRACE_EMPTY, this);
         return _data[_back];
+    }
+    _count--;
+    TRACE(TRACE_POP, this);
+    wakeAll(_writable);
     return _data[next(_back)];
 }
 
+template<typename T, unsigned int i, typename L, typename IT>
+bool Queue<T, i, L, IT>::dequeue(T &out) {
+    return dequeue(out, 0);
+}
+
+template<typename T, unsigned int i, typename L, typename IT>
+bool Queue<T, i, L, IT>::dequeue(T &out, uint64_t timeout) {
+    LockGuard l(_m);
+    if (!waitFor(false, 1, timeout)) {
+        TRACE(TRACE_EMPTY, this);
+        return false;
+    }
+    out = _data[next(_back)];
+    _count--;
+    TRACE(TRACE_POP, this);
+    wakeAll(_writable);
+    return true;
+}
+
+template<typename T, unsigned int i, typename L, typename IT>
+bool Queue<T, i, L, IT>::peek(T &out) {
+    LockGuard l(_m);
+    if (isEmpty())
+        return false;
+    out = _data[_back];
+    return true;
+}
+
+template<typename T, unsigned int i, typename L, typename IT>
+T* Queue<T, i, L, IT>::reserve(uint64_t timeout) {
+    _m.lock();
+    if (!waitFor(true, 1, timeout)) {
+        _m.unlock();
+        return 0;
+    }
+    return &_data[_front];
+}
+
+template<typename T, unsigned int i, typename L, typename IT>
+void Queue<T, i, L, IT>::commit() {
+    next(_front);
+    _count++;
+    TRACE(TRACE_PUSH, this);
+    wakeReaders();
+    _m.unlock();
+}
+
+template<typename T, unsigned int i, typename L, typename IT>
+const T* Queue<T, i, L, IT>::front(uint64_t timeout) {
+    _m.lock();
+    if (!waitFor(false, 1, timeout)) {
+        _m.unlock();
+        return 0;
+    }
+    return &_data[_back];
+}
+
+template<typename T, unsigned int i, typename L, typename IT>
+void Queue<T, i, L, IT>::release() {
+    next(_back);
+    _count--;
+    TRACE(TRACE_POP, this);
+    wakeAll(_writable);
+    _m.unlock();
+}
+
+template<typename T, unsigned int i, typename L, typename IT>
+IT Queue<T, i, L, IT>::dequeue(T* dst, IT n) {
+    return dequeue(dst, n, 0);
+}
+
+template<typename T, unsigned int i, typename L, typename IT>
+IT Queue<T, i, L, IT>::dequeue(T* dst, IT n, uint64_t timeout) {
+    LockGuard l(_m);
+    waitFor(false, n > i ? i : n, timeout);
+    if (n > _count)
+        n = _count;
+    IT first = i - _back < n ? i - _back : n;
+    __DATATYPES__HELPER__::copy(dst, &_data[_back], first);
+    __DATATYPES__HELPER__::copy(dst + first, &_data[0], n - first);
+    _back = _back + n >= i ? _back + n - i : _back + n;
+    _count -= n;
+    if (n != 0) {
+        TRACE(TRACE_POP, this);
+        wakeAll(_writable);
+    } else {
+        TRACE(TRACE_EMPTY, this);
+    }
+    return n;
+}
+
 #endif // !__DATATYPES_QUEUE_H__
 
 /**
@@ -0,0 +1,198 @@
+/**
+ * @file QueueSet.h
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief lets a task wait on several queues, stacks and semaphores at once.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+#ifndef __DATATYPES_QUEUESET_H__
+#define __DATATYPES_QUEUESET_H__
+
+/**
+ * @brief everything a QueueSet does that does not depend on how many members it can hold.
+ * Queue, Stack and Semaphore keep a pointer to this so that they can tell the set when they change.
+ */
+class _QueueSet {
+protected:
+    struct Member {
+        // the Queue, Stack or Semaphore
+        void* obj;
+        // whether it has something to take
+        bool (*ready)(void*);
+    };
+
+    // where the members are kept, which is inside the QueueSet
+    Member* _members;
+    // how many members there is room for
+    uint8_t _size;
+    // how many members there are
+    uint8_t _count;
+    // which member gets checked first next time, so that a busy one can not hide the others
+    uint8_t _next;
+    // the tasks blocked in select()
+    WaitList _waiters;
+
+    _QueueSet(Member* members, uint8_t size) : _members(members), _size(size), _count(0), _next(0) {};
+
+    /**
+     * @brief whether a member has something to take. specialized for members that are not checked with isEmpty().
+     */
+    template<typename M>
+    static bool isReady(void* m) {return !((M*)m)->isEmpty();}
+
+public:
+    /**
+     * @brief adds a Queue, Stack or Semaphore to the set. it can only be in one set at a time.
+     *
+     * @param m the member to add
+     * @return true added
+     * @return false the set is full, or m is already in a set
+     */
+    template<typename M>
+    bool add(M &m) {
+        noInterrupts();
+        if (_count == _size || m._set != 0) {
+            interrupts();
+            return false;
+        }
+        m._set = this;
+        _members[_count].obj = &m;
+        _members[_count].ready = &isReady<M>;
+        _count++;
+        // whoever is waiting may want what is already in it
+        notifyFromISR();
+        interrupts();
+        return true;
+    }
+
+    /**
+     * @brief takes a member back out of the set.
+     *
+     * @param m the member to remove
+     * @return true removed
+     * @return false m is not in this set
+     */
+    template<typename M>
+    bool remove(M &m) {
+        noInterrupts();
+        if (m._set != this) {
+            interrupts();
+            return false;
+        }
+        m._set = 0;
+        uint8_t k = 0;
+        while (_members[k].obj != &m) {
+            k++;
+        }
+        _count--;
+        memmove(&_members[k], &_members[k + 1], (_count - k) * sizeof(Member));
+        if (_next >= _count) {
+            _next = 0;
+        }
+        interrupts();
+        return true;
+    }
+
+    /**
+     * @brief blocks until a member has something to take, and returns it. a Queue or Stack is returned while it is not empty,
+     * and a Semaphore while it is unlocked. members take turns being checked first, so one that is always busy
+     * can not keep the others from being returned.
+     *
+     * nothing is taken from the member. another task can still get to it first, so take from it without waiting,
+     * like dequeue(out) or lockImmediate(), and call select() again if that fails.
+     *
+     * @param timeout how long to wait in milliseconds. 0 does not wait, and WAIT_FOREVER never runs out.
+     * @return void* the member that is ready. compare it against the address of each member. 0 if it timed out.
+     */
+    void* select(unsigned long timeout = WAIT_FOREVER) {
+        unsigned long start = millis();
+        for (;;) {
+            // members only tell the set about changes with interrupts dissabled, so nothing is missed between checking and waiting
+            noInterrupts();
+            for (uint8_t k = 0; k < _count; k++) {
+                Member &m = _members[_next];
+                _next = _next + 1 >= _count ? 0 : _next + 1;
+                if (m.ready(m.obj)) {
+                    interrupts();
+                    return m.obj;
+                }
+            }
+            unsigned long waited = millis() - start;
+            if (waited >= timeout) {
+                interrupts();
+                return 0;
+            }
+            OS.wait(_waiters, timeout == WAIT_FOREVER ? WAIT_FOREVER : timeout - waited);
+        }
+    }
+
+    /**
+     * @brief wakes every task in select() so that they check the members again.
+     * interrupts must be dissabled before calling this.
+     */
+    void notifyFromISR() {
+        while (OS.wake(_waiters) != NO_TASK);
+    }
+
+    /**
+     * @brief wakes every task in select() so that they check the members again.
+     */
+    void notify() {
+        noInterrupts();
+        notifyFromISR();
+        interrupts();
+    }
+
+    /**
+     * @brief returns how many members are in the set
+     */
+    uint8_t size() {return _count;}
+};
+
+/**
+ * @brief a set of Queues, Stacks and Semaphores that one task can wait on all at once, like a task that handles
+ * whatever comes in from the radio, the serial port or the sensors first.
+ * members tell the set when an item is pushed or they are unlocked, so nothing is polled while waiting.
+ *
+ * @tparam N the most members it can hold. defaults to 4
+ */
+template<uint8_t N = 4>
+class QueueSet : public _QueueSet {
+private:
+    Member _storage[N];
+public:
+    /**
+     * @brief Construct a new QueueSet object with no members
+     *
+     */
+    QueueSet() : _QueueSet(_storage, N) {};
+};
+
+#endif // !__DATATYPES_QUEUESET_H__
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
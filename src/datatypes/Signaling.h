@@ -14,11 +14,11 @@
 // hide it away from the users. they dont need to know.
 class _Locking {
 public:
-    virtual void lock();
-    virtual bool lockImmediate();
-    virtual bool unlock();
-    virtual bool available();
-    virtual TaskID getOwner();
+    virtual void lock() = 0;
+    virtual bool lockImmediate() = 0;
+    virtual bool unlock() = 0;
+    virtual bool available() = 0;
+    virtual TaskID getOwner() = 0;
 };
 
 /*
@@ -47,13 +47,20 @@ private:
     // the task that locked the task. this is a utility to prevent a task from getting blocked attempting to re-lock a resource
     volatile TaskID _locking_task;
 
+    // the tasks blocked waiting for the lock. they are not switched to until unlock() hands them the lock.
+    WaitList _waiters;
+
+    // the QueueSet this is in, or 0
+    _QueueSet* _set;
+    friend class _QueueSet;
+
 public:
 
     /**
      * @brief Construct a new Mutex object
      * 
      */
-    Semaphore() : _lock(true) , _locking_task(0xFF) {};
+    Semaphore() : _lock(true) , _locking_task(NO_TASK), _set(0) {};
 
     /**
      * @brief blocks the current task until a lock can be acquired
@@ -63,20 +70,20 @@ public:
         // interrupts are not alloud while mutexes are being sorted out
         noInterrupts();
 
-        // attempt to lock forever;
-        while (!_lock) {
-            OS.yield();
-            // interrups are enabled after OS.yield(), so
-            // we must dissable interrupts before we continue to prevent
-            // data from changing while we are working on it
-            noInterrupts();
-        }
-        // update lock
-        _lock = false;
-        // update locking task
-        _locking_task = OS.getTaskID();
-        // return, enabling interrupts too
-        interrupts();
+        if (_lock) {
+            // update lock
+            _lock = false;
+            // update locking task
+            _locking_task = OS.getTaskID();
+            TRACE_FROM_ISR(TRACE_LOCK, this);
+            // return, enabling interrupts too
+            interrupts();
+            return;
+        }
+        TRACE_FROM_ISR(TRACE_CONTEND, this);
+        // wait until unlock() hands the lock over to us.
+        // interrupts are enabled again once this returns.
+        OS.wait(_waiters);
     }
 
     /**
@@ -87,31 +94,26 @@ public:
      * @return false timed out
      */
     bool lock(unsigned long long timeout) {
-        // set a timeout time.
-        timeout += millis();
         noInterrupts();
 
-        while (!_lock ) {
+        if (_lock) {
+            // update lock
+            _lock = false;
+            // update locking task
+            _locking_task = OS.getTaskID();
+            TRACE_FROM_ISR(TRACE_LOCK, this);
+            // enable interrupts
             interrupts();
-            if (timeout < millis()) {
-                return false;
-            }
-            OS.yield();
-            // interrups are enabled after OS.yield(), so
-            // we must dissable interrupts before we continue to prevent
-            // data from changing while we are working on it
-            // here is where the ISR pertaining to millis has a chance to fire
-            // dissallow interrupts so that we can not be interrupted when checking for the lock again
-            noInterrupts();
+            // return successful lock
+            return true;
         }
-            // update lock
-        _lock = false;
-        // update locking task
-        _locking_task = OS.getTaskID();
-        // enable interrupts
-        interrupts();
-        // return successful lock
-        return true;
+        if (timeout == 0) {
+            interrupts();
+            return false;
+        }
+        TRACE_FROM_ISR(TRACE_CONTEND, this);
+        // the kernel takes care of the timeout. if we were woken up instead, unlock() already made us the owner.
+        return OS.wait(_waiters, timeout > WAIT_FOREVER ? WAIT_FOREVER : (unsigned long)timeout);
     }
 
     /**
@@ -127,6 +129,7 @@ public:
         if(_lock) {
             _lock = false;
             _locking_task = OS.getTaskID();
+            TRACE_FROM_ISR(TRACE_LOCK, this);
             interrupts();
             return true;
         } else {
@@ -136,7 +139,8 @@ public:
     }
 
     /**
-     * @brief frees the lock
+     * @brief frees the lock. if any task is waiting for it, the lock is handed straight to the first one
+     * so that nobody else can take it in the meantime.
      * 
      */
     bool unlock() {
@@ -144,11 +148,22 @@ public:
         noInterrupts();
         // check to see if we own the semaphore
         if (_locking_task != OS.getTaskID()) {
+            interrupts();
             return false;
         }
-        // free the lock
-        _locking_task = 0xFF;
-        _lock = true;
+        TRACE_FROM_ISR(TRACE_UNLOCK, this);
+        TaskID next = OS.wake(_waiters);
+        if (next == NO_TASK) {
+            // free the lock
+            _locking_task = NO_TASK;
+            _lock = true;
+            if (_set != 0) {
+                _set->notifyFromISR();
+            }
+        } else {
+            // the lock stays taken, it just has a new owner
+            _locking_task = next;
+        }
         interrupts();
         return true;
     }
@@ -170,6 +185,93 @@ public:
     TaskID getOwner() {return _locking_task;};
 };
 
+// a Semaphore in a QueueSet is ready while it can be locked
+template<>
+inline bool _QueueSet::isReady<Semaphore>(void* m) {return ((Semaphore*)m)->available();}
+
+/**
+ * @brief a semaphore that counts, for things like how many buffers are free or how many button presses are waiting.
+ * unlike Semaphore, it has no owner, so any task or ISR can give and any task can take.
+ * 
+ * @tparam Max the highest the count can go. defaults to 255
+ * @tparam IT Generated at compile time. Do not put insert anything into this spot. 
+ */
+template<unsigned int Max = 255, typename IT = __IT_TYPE__(Max)>
+class CountingSemaphore {
+private:
+    // how many times it can be taken without waiting
+    volatile IT _count;
+
+    // the tasks blocked waiting to take it. they are not switched to until give() hands them a count.
+    WaitList _waiters;
+
+public:
+    /**
+     * @brief Construct a new CountingSemaphore object
+     * 
+     * @param initial what the count starts at
+     */
+    CountingSemaphore(IT initial = 0) : _count(initial > Max ? Max : initial) {};
+
+    /**
+     * @brief takes one from the count, blocking until there is one to take or the timeout runs out
+     * 
+     * @param timeout how long to wait in milliseconds. 0 does not wait, and WAIT_FOREVER never runs out.
+     * @return true taken
+     * @return false timed out
+     */
+    bool take(unsigned long timeout = WAIT_FOREVER) {
+        noInterrupts();
+        if (_count != 0) {
+            _count--;
+            interrupts();
+            return true;
+        }
+        if (timeout == 0) {
+            interrupts();
+            return false;
+        }
+        // if we are woken up, give() handed its count straight to us
+        return OS.wait(_waiters, timeout);
+    }
+
+    /**
+     * @brief adds one to the count. if a task is waiting, it gets it straight away so that nobody else can take it in the meantime.
+     * interrupts must be dissabled before calling this, so it is safe to use inside ISRs.
+     * 
+     * @return true given
+     * @return false the count was already at Max
+     */
+    bool giveFromISR() {
+        if (OS.wake(_waiters) != NO_TASK) {
+            return true;
+        }
+        if (_count == Max) {
+            return false;
+        }
+        _count++;
+        return true;
+    }
+
+    /**
+     * @brief adds one to the count. if a task is waiting, it gets it straight away so that nobody else can take it in the meantime.
+     * 
+     * @return true given
+     * @return false the count was already at Max
+     */
+    bool give() {
+        noInterrupts();
+        bool given = giveFromISR();
+        interrupts();
+        return given;
+    }
+
+    /**
+     * @brief returns how many times it can be taken without waiting
+     */
+    IT count() {return _count;}
+};
+
 /*
 888b     d888 888     888 88888888888 8888888888 Y88b   d88P
 8888b   d8888 888     888     888     888         Y88b d88P
@@ -180,13 +282,352 @@ public:
 888   "   888 Y88b. .d88P     888     888         d88P Y88b
 888       888  "Y88888P"      888     8888888888 d88P   Y88b
 */
-#ifndef COOP_ONLY
-// since priorities are not a thing in cooperative Operating systems, this is simply a placeholder for the Preemptive version.
-typedef Semaphore Mutex;
-#else
-// because the OS is limited to coop only, the mutexes and semaphores become practically the same.
-typedef Semaphore Mutex;
-#endif
+
+/**
+ * @brief a lock that its owner can take again without blocking itself, and that lends its owner the priority of
+ * whoever is waiting on it. that way a low priority task holding the lock cannot keep a high priority task
+ * waiting behind every medium priority task.
+ * 
+ * the scheduler keeps track of every Mutex a task holds, so unlocking one only drops the owner as far as the
+ * priority it was given or that of whoever is still waiting on another Mutex it holds, whichever is higher.
+ */
+class Mutex: public _Locking {
+private:
+    // the task that holds the lock, or NO_TASK
+    volatile TaskID _owner;
+
+    // how many more times the owner has to unlock it before it is free
+    unsigned char _depth;
+
+    // how many times a waiting task lent its priority to the owner
+    unsigned long _inherited;
+
+    // the tasks blocked waiting for the lock, highest priority first
+    WaitList _waiters;
+
+    // the next Mutex the owner holds. only the scheduler touches this.
+    Mutex* _nextHeld;
+    friend class Scheduler;
+
+    /**
+     * @brief makes a task the owner. interrupts must be dissabled before calling this.
+     */
+    void take(TaskID t) {
+        _owner = t;
+        _depth = 1;
+        OS.holdMutex(t, this);
+    }
+
+public:
+    /**
+     * @brief Construct a new Mutex object
+     * 
+     */
+    Mutex() : _owner(NO_TASK), _depth(0), _inherited(0), _nextHeld(0) {};
+
+    /**
+     * @brief blocks the current task until the lock is acquired or times out.
+     * if the owner has a lower priority than the current task, it runs at the current tasks priority until it unlocks.
+     * 
+     * @param timeout how long to wait in milliseconds. 0 does not wait, and WAIT_FOREVER never runs out.
+     * @return true lock successfully acquired
+     * @return false timed out, or the owner already has it locked 255 times
+     */
+    bool lock(unsigned long long timeout) {
+        noInterrupts();
+        TaskID me = OS.getTaskID();
+        if (_owner == NO_TASK) {
+            take(me);
+            TRACE_FROM_ISR(TRACE_LOCK, this);
+            interrupts();
+            return true;
+        }
+        if (_owner == me) {
+            // one more would wrap around, and the next unlock would free it while the owner still thinks it holds it
+            if (_depth == 0xFF) {
+                interrupts();
+                return false;
+            }
+            _depth++;
+            interrupts();
+            return true;
+        }
+        if (timeout == 0) {
+            interrupts();
+            return false;
+        }
+        TRACE_FROM_ISR(TRACE_CONTEND, this);
+        if (OS.getPriority(me) > OS.getPriority(_owner)) {
+            OS.raisePriority(_owner, OS.getPriority(me));
+            _inherited++;
+        }
+        // if we were woken up, unlock() already made us the owner
+        if (OS.wait(_waiters, timeout > WAIT_FOREVER ? WAIT_FOREVER : (unsigned long)timeout)) {
+            return true;
+        }
+
+        // we are not waiting anymore, so the owner only needs to keep whatever it is still owed
+        noInterrupts();
+        if (_owner != NO_TASK) {
+            OS.restorePriority(_owner);
+        }
+        interrupts();
+        return false;
+    }
+
+    /**
+     * @brief blocks the current task until the lock is acquired
+     * 
+     */
+    void lock() {lock(WAIT_FOREVER);}
+
+    /**
+     * @brief used to fetch the lock if available. does not wait, does not block.
+     * 
+     * @return true lock fetched
+     * @return false lock not available
+     */
+    bool lockImmediate() {return lock(0);}
+
+    /**
+     * @brief frees the lock once it has been unlocked as many times as it was locked.
+     * the owner goes back to its own priority, and the lock is handed straight to the highest priority waiter.
+     * 
+     * @return true unlocked
+     * @return false the current task does not own the lock
+     */
+    bool unlock() {
+        noInterrupts();
+        TaskID me = OS.getTaskID();
+        if (_owner != me) {
+            interrupts();
+            return false;
+        }
+        if (--_depth != 0) {
+            interrupts();
+            return true;
+        }
+        TRACE_FROM_ISR(TRACE_UNLOCK, this);
+        // the owner goes back to its own priority, unless another Mutex it holds still has someone waiting
+        OS.releaseMutex(me, this);
+        TaskID next = OS.wake(_waiters);
+        if (next == NO_TASK) {
+            _owner = NO_TASK;
+        } else {
+            // next is the highest priority waiter. whoever is still waiting now lends their priority to it instead.
+            take(next);
+        }
+        interrupts();
+        return true;
+    }
+
+    /**
+     * @brief returns the availability of the mutex
+     * 
+     * @return true available
+     * @return false not available
+     */
+    bool available() {return _owner == NO_TASK;};
+
+    /**
+     * @brief returns the task that currently owns the lock
+     * 
+     * @return TaskID the task that owns the lock
+     */
+    TaskID getOwner() {return _owner;};
+
+    /**
+     * @brief returns how many times a waiting task has lent its priority to the owner
+     */
+    unsigned long getInheritCount() {return _inherited;};
+};
+/*
+8888888888 888     888 8888888888 888b    888 88888888888  .d8888b.
+888        888     888 888        8888b   888     888     d88P  Y88b
+888        888     888 888        88888b  888     888     Y88b.
+8888888    Y88b   d88P 8888888    888Y88b 888     888      "Y888b.
+888         Y88b d88P  888        888 Y88b888     888         "Y88b.
+888          Y88o88P   888        888  Y88888     888           "888
+888           Y888P    888        888   Y8888     888     Y88b  d88P
+8888888888     Y8P     8888888888 888    Y888     888      "Y8888P"
+*/
+
+// one bit per event in an EventGroup
+typedef unsigned int EventBits;
+
+/**
+ * @brief a set of event bits that tasks can wait on. a task can wait for any one of several bits or for all of them,
+ * so one task can wake on "new sample OR config changed OR shutdown" without polling anything.
+ * waiting tasks are not switched to until a matching bit is set.
+ */
+class EventGroup {
+private:
+    /**
+     * @brief a task waiting on the group. this lives on the waiting tasks stack, so waiting costs the group nothing.
+     */
+    struct Waiter {
+        // the bits being waited on
+        EventBits want;
+        // whether every bit in want has to be set, or just one
+        bool all;
+        // whether to clear the bits in want once the wait is over
+        bool clear;
+        // the bits that were set when the wait was over. stays 0 until then.
+        EventBits got;
+        // the task itself
+        WaitList list;
+        // the next waiter on the group
+        Waiter* next;
+    };
+
+    // the events that are currently set
+    volatile EventBits _bits;
+
+    // every task waiting on the group, in the order they started waiting
+    Waiter* _waiters;
+
+    /**
+     * @brief checks whether the bits satisfy a waiter
+     */
+    static bool matches(EventBits bits, EventBits want, bool all) {
+        return all ? (bits & want) == want : (bits & want) != 0;
+    }
+
+    /**
+     * @brief blocks until the bits satisfy the wait or the timeout runs out
+     */
+    EventBits wait(EventBits bits, bool all, bool clear, unsigned long timeout) {
+        noInterrupts();
+        EventBits now = _bits;
+        if (matches(now, bits, all)) {
+            if (clear) {
+                _bits = now & ~bits;
+            }
+            interrupts();
+            return now;
+        }
+        if (timeout == 0) {
+            interrupts();
+            return 0;
+        }
+        Waiter w;
+        w.want = bits;
+        w.all = all;
+        w.clear = clear;
+        w.got = 0;
+        w.next = 0;
+        Waiter** n = &_waiters;
+        while (*n != 0) {
+            n = &(*n)->next;
+        }
+        *n = &w;
+        OS.wait(w.list, timeout);
+
+        noInterrupts();
+        if (w.got == 0) {
+            // timed out, so nobody took us off of the list
+            n = &_waiters;
+            while (*n != &w) {
+                n = &(*n)->next;
+            }
+            *n = w.next;
+        }
+        interrupts();
+        return w.got;
+    }
+public:
+    /**
+     * @brief Construct a new EventGroup object with every bit cleared
+     * 
+     */
+    EventGroup() : _bits(0), _waiters(0) {};
+
+    /**
+     * @brief sets bits and wakes every task whose wait is now satisfied, all in one pass.
+     * interrupts must be dissabled before calling this, so it is safe to use inside ISRs.
+     * 
+     * @param bits the bits to set
+     * @return EventBits the bits that are still set afterwards
+     */
+    EventBits setFromISR(EventBits bits) {
+        EventBits now = _bits | bits;
+        // bits are cleared after every waiter has been checked so that each one sees the same bits
+        EventBits cleared = 0;
+        Waiter** n = &_waiters;
+        while (*n != 0) {
+            Waiter* w = *n;
+            if (matches(now, w->want, w->all)) {
+                w->got = now;
+                if (w->clear) {
+                    cleared |= w->want;
+                }
+                *n = w->next;
+                OS.wake(w->list);
+            } else {
+                n = &w->next;
+            }
+        }
+        _bits = now & ~cleared;
+        return _bits;
+    }
+
+    /**
+     * @brief sets bits and wakes every task whose wait is now satisfied, all in one pass.
+     * 
+     * @param bits the bits to set
+     * @return EventBits the bits that are still set afterwards
+     */
+    EventBits set(EventBits bits) {
+        noInterrupts();
+        EventBits now = setFromISR(bits);
+        interrupts();
+        return now;
+    }
+
+    /**
+     * @brief clears bits
+     * 
+     * @param bits the bits to clear
+     * @return EventBits the bits that were set beforehand
+     */
+    EventBits clear(EventBits bits) {
+        noInterrupts();
+        EventBits was = _bits;
+        _bits = was & ~bits;
+        interrupts();
+        return was;
+    }
+
+    /**
+     * @brief returns the bits that are currently set
+     */
+    EventBits get() {
+        noInterrupts();
+        EventBits now = _bits;
+        interrupts();
+        return now;
+    }
+
+    /**
+     * @brief blocks the current task until at least one of the bits is set
+     * 
+     * @param bits the bits to wait on
+     * @param timeout how long to wait in milliseconds. WAIT_FOREVER never runs out.
+     * @param clear whether to clear the bits given once the wait is over
+     * @return EventBits every bit that was set when the wait was over, or 0 if it timed out
+     */
+    EventBits waitAny(EventBits bits, unsigned long timeout=WAIT_FOREVER, bool clear=false) {return wait(bits, false, clear, timeout);}
+
+    /**
+     * @brief blocks the current task until every one of the bits is set
+     * 
+     * @param bits the bits to wait on
+     * @param timeout how long to wait in milliseconds. WAIT_FOREVER never runs out.
+     * @param clear whether to clear the bits given once the wait is over
+     * @return EventBits every bit that was set when the wait was over, or 0 if it timed out
+     */
+    EventBits waitAll(EventBits bits, unsigned long timeout=WAIT_FOREVER, bool clear=false) {return wait(bits, true, clear, timeout);}
+};
 /*
 888      .d88888b.   .d8888b.  888    d8P   .d8888b.  888     888       d8888 8888888b.  8888888b.
 888     d88P" "Y88b d88P  Y88b 888   d8P   d88P  Y88b 888     888      d88888 888   Y88b 888  "Y88b
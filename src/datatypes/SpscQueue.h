@@ -0,0 +1,181 @@
+/**
+ * @file SpscQueue.h
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief provides a lock free queue for handing data from one producer to one consumer, like an ISR to a task.
+ * @version 0.1
+ * @date 2022-04-03
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+#ifndef __DATATYPES_SPSCQUEUE_H__
+#define __DATATYPES_SPSCQUEUE_H__
+
+/**
+ * @brief a queue with exactly one producer and one consumer that needs no lock at all.
+ * the producer only ever writes _head and the consumer only ever writes _tail, and both are read and written
+ * in a single instruction, so the producer can be an ISR without it ever having to mask interrupts.
+ *
+ * the consumer can block until something arrives. the producer never blocks, enqueueing onto a full queue just fails.
+ *
+ * @tparam T The type of data stored in the SpscQueue
+ * @tparam N The maximum number of datapoints in the SpscQueue. must be a power of 2. at most 128 on AVR.
+ * @tparam IT Generated at compile time. Do not put insert anything into this spot.
+ */
+template<typename T, unsigned int N=16, typename IT = __IT_TYPE__(N)>
+class SpscQueue {
+private:
+    static_assert(N != 0 && (N & (N - 1)) == 0, "SpscQueue size must be a power of 2");
+#ifdef __AVR__
+    static_assert(sizeof(IT) == 1, "SpscQueue can hold at most 128 items on AVR, since only bytes are read in one instruction");
+#else
+    static_assert(sizeof(IT) <= sizeof(void*), "SpscQueue indexes must fit in a register");
+#endif
+
+    T _data[N];                   /** where the data is actually stored */
+    // both of these count up forever and are masked on use, so full and empty can be told apart without a counter.
+    volatile IT _head;            /** how many items have been enqueued. only written by the producer */
+    volatile IT _tail;            /** how many items have been dequeued. only written by the consumer */
+    WaitList _waiter;             /** the consumer, if it is blocked waiting for data */
+
+    /**
+     * @brief wakes the consumer if it is waiting. interrupts must be dissabled before calling this.
+     */
+    void wakeConsumer() {
+        if (!_waiter.isEmpty()) {
+            OS.wake(_waiter);
+        }
+    }
+public:
+    /**
+     * @brief Construct a new SpscQueue object
+     *
+     */
+    SpscQueue() : _head(0), _tail(0) {};
+
+    /**
+     * @brief used by the producer task to enqueue another item at the end of the queue without waiting for anything.
+     * only masks interrupts if the consumer has to be woken up.
+     *
+     * @param inp The item to push onto the end of the queue
+     * @return true successfull queueing
+     * @return false the queue was full
+     */
+    bool enqueue(const T &inp);
+
+    /**
+     * @brief used by the producer ISR to enqueue another item at the end of the queue.
+     * interrupts must already be dissabled, which they are inside an ISR.
+     *
+     * @param inp The item to push onto the end of the queue
+     * @return true successfull queueing
+     * @return false the queue was full
+     */
+    bool enqueueFromISR(const T &inp);
+
+    /**
+     * @brief Take an item off of the queue without waiting for anything.
+     *
+     * @param out where to put the item dequeued
+     * @return true an item was dequeued
+     * @return false the queue was empty. out is left alone.
+     */
+    bool dequeue(T &out);
+
+    /**
+     * @brief Take an item off of the queue, blocking until one arrives.
+     * the consumer is not switched back in until the producer enqueues something.
+     *
+     * @param out where to put the item dequeued
+     * @param timeout how long to wait in milliseconds. WAIT_FOREVER never runs out.
+     * @return true an item was dequeued
+     * @return false timed out. out is left alone.
+     */
+    bool dequeue(T &out, unsigned long timeout);
+
+    IT size() {return (IT)(_head - _tail);}
+    bool isEmpty() {return _head == _tail;}
+    bool isFull() {return (IT)(_head - _tail) == N;}
+};
+
+template<typename T, unsigned int N, typename IT>
+bool SpscQueue<T, N, IT>::enqueueFromISR(const T &inp) {
+    IT h = _head;
+    if ((IT)(h - _tail) == N)
+        return false;
+    _data[h & (N - 1)] = inp;
+    // the data has to land before the consumer can see the new head
+    __asm__ __volatile__ ("" ::: "memory");
+    _head = h + 1;
+    wakeConsumer();
+    return true;
+}
+
+template<typename T, unsigned int N, typename IT>
+bool SpscQueue<T, N, IT>::enqueue(const T &inp) {
+    IT h = _head;
+    if ((IT)(h - _tail) == N)
+        return false;
+    _data[h & (N - 1)] = inp;
+    __asm__ __volatile__ ("" ::: "memory");
+    _head = h + 1;
+    if (!_waiter.isEmpty()) {
+        noInterrupts();
+        wakeConsumer();
+        interrupts();
+    }
+    return true;
+}
+
+template<typename T, unsigned int N, typename IT>
+bool SpscQueue<T, N, IT>::dequeue(T &out) {
+    IT t = _tail;
+    if (_head == t)
+        return false;
+    out = _data[t & (N - 1)];
+    // the slot has to be read before the producer can reuse it
+    __asm__ __volatile__ ("" ::: "memory");
+    _tail = t + 1;
+    return true;
+}
+
+template<typename T, unsigned int N, typename IT>
+bool SpscQueue<T, N, IT>::dequeue(T &out, unsigned long timeout) {
+    if (dequeue(out))
+        return true;
+    if (timeout == 0)
+        return false;
+    // the producer cannot slip something in between checking and waiting with interrupts dissabled.
+    noInterrupts();
+    if (isEmpty() && !OS.wait(_waiter, timeout)) {
+        return false;
+    }
+    interrupts();
+    return dequeue(out);
+}
+
+#endif // !__DATATYPES_SPSCQUEUE_H__
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
\ No newline at end of file
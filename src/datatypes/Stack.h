@@ -21,6 +21,36 @@ private:
     T _data[i];
     // how far are we on our storage
     IT _num;
+    // tasks waiting for something to be pushed
+    WaitList _readable;
+    // tasks waiting for something to be popped
+    WaitList _writable;
+    // the QueueSet this is in, or 0
+    _QueueSet* _set;
+    friend class _QueueSet;
+
+    /**
+     * @brief blocks until there is room to push or something to pop, or the timeout runs out.
+     * must be called with the lock held, and returns with it held. the lock is given up while waiting.
+     * 
+     * @param space true to wait for room, false to wait for something to pop
+     * @param timeout how long to wait in milliseconds
+     * @return true ready
+     * @return false timed out
+     */
+    bool waitFor(bool space, uint64_t timeout);
+
+    /**
+     * @brief wakes every task in the list so they can check whether they can go ahead.
+     * 
+     * @param list the list to wake
+     */
+    void wakeAll(WaitList &list);
+
+    /**
+     * @brief wakes every task waiting to pop, and tells the QueueSet this is in that there is something to pop.
+     */
+    void wakeReaders();
 public:
     /**
      * @brief Construct a new Stack object
@@ -92,7 +122,7 @@ public:
      * @brief clears all elements from the stack
      * 
      */
-    void clear() {_num = 0;};
+    void clear();
 
     _Locking& getLock() {return _m;}
     void lock() {_m.lock();}
@@ -103,62 +133,98 @@ public:
 };
 
 template<typename T, unsigned int i, typename L, typename IT>
-Stack<T, i, L, IT>::Stack(): _num(0) {};
+bool Stack<T, i, L, IT>::waitFor(bool space, uint64_t timeout) {
+    unsigned long start = millis();
+    while (space ? isFull() : isEmpty()) {
+        unsigned long waited = millis() - start;
+        if (waited >= timeout) {
+            return false;
+        }
+        _m.unlock();
+        // nothing can change the stack while interrupts are off, so nothing is missed between checking and waiting
+        noInterrupts();
+        if (space ? isFull() : isEmpty()) {
+            OS.wait(space ? _writable : _readable, timeout > WAIT_FOREVER ? WAIT_FOREVER : (unsigned long)(timeout - waited));
+        } else {
+            interrupts();
+        }
+        _m.lock();
+    }
+    return true;
+}
+
+template<typename T, unsigned int i, typename L, typename IT>
+void Stack<T, i, L, IT>::wakeAll(WaitList &list) {
+    if (list.isEmpty())
+        return;
+    noInterrupts();
+    while (OS.wake(list) != NO_TASK);
+    interrupts();
+}
+
+template<typename T, unsigned int i, typename L, typename IT>
+void Stack<T, i, L, IT>::wakeReaders() {
+    if (_readable.isEmpty() && _set == 0)
+        return;
+    noInterrupts();
+    while (OS.wake(_readable) != NO_TASK);
+    if (_set != 0) {
+        _set->notifyFromISR();
+    }
+    interrupts();
+}
+
+template<typename T, unsigned int i, typename L, typename IT>
+Stack<T, i, L, IT>::Stack(): _num(0), _set(0) {};
 
 template<typename T, unsigned int i, typename L, typename IT>
 bool Stack<T, i, L, IT>::push(T inp) {
-    LockGuard l(_m);
-    if (isFull())
-        return false;
-    _data[_num] = inp;
-    _num += 1;
-    return true;
+    return push(inp, 0);
 };
 
 template<typename T, unsigned int i, typename L, typename IT>
 bool Stack<T, i, L, IT>::push(T inp, uint64_t timeout) {
-    timeout += millis();
-
-    _m.lock();
-    while (isFull() && timeout < millis()) {
-        _m.unlock();
-        OS.yield();
-        _m.lock();
-    }
-
-    if (timeout >= millis()) {
-        _m.unlock();
+    LockGuard l(_m);
+    if (!waitFor(true, timeout)) {
+        TRACE(TRACE_FULL, this);
         return false;
     }
-
     _data[_num++] = inp;
-    _m.unlock();
+    TRACE(TRACE_PUSH, this);
+    wakeReaders();
     return true;
 };
 
 template<typename T, unsigned int i, typename L, typename IT>
 T Stack<T, i, L, IT>::pop() {
+    return pop(0);
+}
+
+template<typename T, unsigned int i, typename L, typename IT>
+T Stack<T, i, L, IT>::pop(uint64_t timeout) {
+    // this will call the deconstructor, unlocking it after the item is copied out.
     LockGuard l(_m);
-    if (isEmpty())
+    if (!waitFor(false, timeout)) {
+        TRACE(TRACE_EMPTY, this);
         return _data[_num];
+    }
+    TRACE(TRACE_POP, this);
+    wakeAll(_writable);
     return _data[--_num];
 }
+
 template<typename T, unsigned int i, typename L, typename IT>
-T Stack<T, i, L, IT>::pop(uint64_t timeout) {
-    timeout += millis();
-    _m.lock();
-    while (isEmpty() && timeout >= millis()) {
-        _m.unlock();
-        OS.yield();
-        _m.lock();
-    }
-    // since I already have the lock, this should not spend any time waiting.
-    return pop();
+void Stack<T, i, L, IT>::clear() {
+    LockGuard l(_m);
+    _num = 0;
+    wakeAll(_writable);
 }
+
 template<typename T, unsigned int i, typename L, typename IT>
 T Stack<T, i, L, IT>::top() {
     LockGuard l(_m);
-    return _data[_num];
+    // the top is just below _num. when empty, this is the same copy pop() hands back.
+    return _data[_num == 0 ? 0 : _num - 1];
 }
 
 #endif // !__DATATYPES_STACK_H__
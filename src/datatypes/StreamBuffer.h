@@ -0,0 +1,306 @@
+/**
+ * @file StreamBuffer.h
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief provides a byte ring for handing a stream of bytes from one writer to one reader, like a uart ISR to a task.
+ * @version 0.1
+ * @date 2022-04-05
+ *
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ */
+
+#ifndef __DATATYPES_STREAMBUFFER_H__
+#define __DATATYPES_STREAMBUFFER_H__
+
+/**
+ * @brief the ring under StreamBuffer and MessageBuffer. like SpscQueue, the writer only ever writes _head and the reader
+ * only ever writes _tail, so the writer can be an ISR without either side taking a lock.
+ *
+ * @tparam Bytes how many bytes the ring holds. must be a power of 2.
+ * @tparam IT Generated at compile time. Do not put insert anything into this spot.
+ */
+template<unsigned int Bytes, typename IT>
+class _ByteRing {
+protected:
+    static_assert(Bytes != 0 && (Bytes & (Bytes - 1)) == 0, "the size of a StreamBuffer or MessageBuffer must be a power of 2");
+
+    uint8_t _data[Bytes];         /** where the bytes are actually stored */
+    // both of these count up forever and are masked on use, so full and empty can be told apart without a counter.
+    volatile IT _head;            /** how many bytes have been written. only written by the writer */
+    volatile IT _tail;            /** how many bytes have been read. only written by the reader */
+    WaitList _reader;             /** the reader, if it is blocked waiting for bytes */
+
+    _ByteRing() : _head(0), _tail(0) {};
+
+    /**
+     * @brief reads an index that the other side writes. anything wider than a byte takes more than one instruction on AVR,
+     * so interrupts are masked to keep an ISR from changing it halfway through. only for tasks, ISRs just read it.
+     */
+    static IT load(volatile IT &v) {
+#ifdef __AVR__
+        if (sizeof(IT) > 1) {
+            noInterrupts();
+            IT r = v;
+            interrupts();
+            return r;
+        }
+#endif
+        return v;
+    }
+
+    /**
+     * @brief writes an index that the other side reads, in one go as far as an ISR can tell. only for tasks.
+     */
+    static void store(volatile IT &v, IT x) {
+        // whatever was copied in or out has to be done before the other side can see the new index
+        __asm__ __volatile__ ("" ::: "memory");
+#ifdef __AVR__
+        if (sizeof(IT) > 1) {
+            noInterrupts();
+            v = x;
+            interrupts();
+            return;
+        }
+#endif
+        v = x;
+    }
+
+    /**
+     * @brief copies bytes into the ring at a position, in at most two blocks.
+     */
+    void copyIn(IT at, const uint8_t* src, IT n) {
+        IT pos = at & (Bytes - 1);
+        IT first = Bytes - pos < n ? Bytes - pos : n;
+        memcpy(&_data[pos], src, first);
+        memcpy(&_data[0], src + first, n - first);
+    }
+
+    /**
+     * @brief copies bytes out of the ring from a position, in at most two blocks.
+     */
+    void copyOut(uint8_t* dst, IT at, IT n) {
+        IT pos = at & (Bytes - 1);
+        IT first = Bytes - pos < n ? Bytes - pos : n;
+        memcpy(dst, &_data[pos], first);
+        memcpy(dst + first, &_data[0], n - first);
+    }
+
+    /**
+     * @brief blocks the reader until there are at least need bytes or the timeout runs out.
+     * the writer only wakes the reader once there are enough, so this only waits once.
+     *
+     * @param need how many bytes to wait for
+     * @param timeout how long to wait in milliseconds. 0 does not wait, and WAIT_FOREVER never runs out.
+     * @return true there are enough
+     * @return false timed out
+     */
+    bool waitFor(IT need, unsigned long timeout) {
+        // the writer cannot slip something in between checking and waiting with interrupts dissabled.
+        noInterrupts();
+        if ((IT)(_head - _tail) >= need) {
+            interrupts();
+            return true;
+        }
+        if (timeout == 0) {
+            interrupts();
+            return false;
+        }
+        return OS.wait(_reader, timeout);
+    }
+
+    /**
+     * @brief wakes the reader if it is waiting. interrupts must be dissabled before calling this.
+     */
+    void wakeReader() {
+        if (!_reader.isEmpty()) {
+            OS.wake(_reader);
+        }
+    }
+
+public:
+    /**
+     * @brief returns how many bytes are waiting to be read
+     */
+    IT size() {return (IT)(load(_head) - load(_tail));}
+    /**
+     * @brief returns how many bytes can be written before it is full
+     */
+    IT space() {return Bytes - size();}
+    bool isEmpty() {return size() == 0;}
+    bool isFull() {return size() == Bytes;}
+};
+
+/**
+ * @brief a byte stream with exactly one writer and one reader, for things like characters from a serial port.
+ * bytes are copied in and out in at most two blocks, and the reader can use them right where they are with front().
+ *
+ * the reader can block until at least the trigger level of bytes has arrived, so a task that handles 16 bytes at a time
+ * is not woken for every one of them. the writer never blocks, writing more than there is room for only writes what fits.
+ *
+ * @tparam Bytes how many bytes it holds. must be a power of 2.
+ * @tparam IT Generated at compile time. Do not put insert anything into this spot.
+ */
+template<unsigned int Bytes = 64, typename IT = __IT_TYPE__(Bytes)>
+class StreamBuffer : public _ByteRing<Bytes, IT> {
+private:
+    typedef _ByteRing<Bytes, IT> Ring;
+    using Ring::_data;
+    using Ring::_head;
+    using Ring::_tail;
+    using Ring::load;
+    using Ring::store;
+
+    // how many bytes have to be waiting before the reader is woken up
+    IT _trigger;
+
+public:
+    /**
+     * @brief Construct a new StreamBuffer object
+     *
+     * @param trigger how many bytes have to be waiting before a blocked reader is woken up. defaults to 1
+     */
+    StreamBuffer(IT trigger = 1) {setTrigger(trigger);}
+
+    /**
+     * @brief changes how many bytes have to be waiting before a blocked reader is woken up.
+     *
+     * @param trigger the trigger level, from 1 up to Bytes
+     */
+    void setTrigger(IT trigger) {_trigger = trigger == 0 ? 1 : trigger > Bytes ? Bytes : trigger;}
+
+    /**
+     * @brief used by the writer task to write as many bytes as there is room for without waiting for anything.
+     * only masks interrupts if the reader has to be woken up.
+     *
+     * @param src the bytes to write
+     * @param n how many bytes there are
+     * @return IT how many bytes were written
+     */
+    IT write(const void* src, IT n);
+
+    /**
+     * @brief used by the writer ISR to write as many bytes as there is room for.
+     * interrupts must already be dissabled, which they are inside an ISR.
+     *
+     * @param src the bytes to write
+     * @param n how many bytes there are
+     * @return IT how many bytes were written
+     */
+    IT writeFromISR(const void* src, IT n);
+
+    /**
+     * @brief reads up to n bytes. if there are fewer than the trigger level waiting, this blocks until there are
+     * or the timeout runs out, then reads whatever is there.
+     *
+     * @param dst where to put the bytes
+     * @param n the most bytes to read
+     * @param timeout how long to wait in milliseconds. 0 does not wait, and WAIT_FOREVER never runs out.
+     * @return IT how many bytes were read
+     */
+    IT read(void* dst, IT n, unsigned long timeout = 0);
+
+    /**
+     * @brief gets the waiting bytes so the reader can use them right where they are instead of copying them out.
+     * waits for the trigger level the same way read() does. nothing is taken until release() is called.
+     *
+     * @param n set to how many bytes follow the pointer. bytes that wrap around past the end of the ring
+     * come from the next front() after releasing these.
+     * @param timeout how long to wait in milliseconds. 0 does not wait, and WAIT_FOREVER never runs out.
+     * @return const uint8_t* the first waiting byte, or 0 if there are none
+     */
+    const uint8_t* front(IT &n, unsigned long timeout = 0);
+
+    /**
+     * @brief takes bytes from front() off of the buffer so the writer can reuse their space.
+     *
+     * @param n how many bytes to take
+     */
+    void release(IT n);
+};
+
+template<unsigned int Bytes, typename IT>
+IT StreamBuffer<Bytes, IT>::writeFromISR(const void* src, IT n) {
+    IT h = _head;
+    IT room = Bytes - (IT)(h - _tail);
+    if (n > room)
+        n = room;
+    this->copyIn(h, (const uint8_t*)src, n);
+    __asm__ __volatile__ ("" ::: "memory");
+    _head = h + n;
+    if ((IT)(_head - _tail) >= _trigger) {
+        this->wakeReader();
+    }
+    return n;
+}
+
+template<unsigned int Bytes, typename IT>
+IT StreamBuffer<Bytes, IT>::write(const void* src, IT n) {
+    IT h = _head;
+    IT room = Bytes - (IT)(h - load(_tail));
+    if (n > room)
+        n = room;
+    this->copyIn(h, (const uint8_t*)src, n);
+    store(_head, h + n);
+    if (!this->_reader.isEmpty()) {
+        noInterrupts();
+        if ((IT)(_head - _tail) >= _trigger) {
+            this->wakeReader();
+        }
+        interrupts();
+    }
+    return n;
+}
+
+template<unsigned int Bytes, typename IT>
+IT StreamBuffer<Bytes, IT>::read(void* dst, IT n, unsigned long timeout) {
+    this->waitFor(_trigger, timeout);
+    IT t = _tail;
+    IT waiting = load(_head) - t;
+    if (n > waiting)
+        n = waiting;
+    this->copyOut((uint8_t*)dst, t, n);
+    store(_tail, t + n);
+    return n;
+}
+
+template<unsigned int Bytes, typename IT>
+const uint8_t* StreamBuffer<Bytes, IT>::front(IT &n, unsigned long timeout) {
+    this->waitFor(_trigger, timeout);
+    IT t = _tail;
+    IT waiting = load(_head) - t;
+    IT pos = t & (Bytes - 1);
+    n = Bytes - pos < waiting ? Bytes - pos : waiting;
+    return n == 0 ? 0 : &_data[pos];
+}
+
+template<unsigned int Bytes, typename IT>
+void StreamBuffer<Bytes, IT>::release(IT n) {
+    IT t = _tail;
+    IT waiting = load(_head) - t;
+    store(_tail, t + (n > waiting ? waiting : n));
+}
+
+#endif // !__DATATYPES_STREAMBUFFER_H__
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022 Alex Olson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
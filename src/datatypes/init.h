@@ -32,14 +32,34 @@ namespace __DATATYPES__HELPER__ {
 	template<> struct Index<true, true> {
 		using Type = uint8_t;
 	};
+
+	/**
+	 * @brief copies n items from src to dst. types that can be copied bit for bit go through memcpy,
+	 * everything else is assigned one at a time. the check is done at compile time.
+	 */
+	template<typename T> inline void copy(T* dst, const T* src, unsigned n) {
+		if (__is_trivially_copyable(T)) {
+			memcpy((void*)dst, (const void*)src, n * sizeof(T));
+		} else {
+			for (unsigned k = 0; k < n; k++) {
+				dst[k] = src[k];
+			}
+		}
+	}
 }
 
 // used to hide the jumble from users
 #define __IT_TYPE__(v) typename __DATATYPES__HELPER__::Index<(v<UINT8_MAX-1),(v<UINT16_MAX-1)>::Type
 
+// first, since the datatypes below tell a QueueSet when they change
+#include "datatypes/QueueSet.h"
 #include "datatypes/Signaling.h"
 #include "datatypes/Queue.h"
+#include "datatypes/SpscQueue.h"
+#include "datatypes/StreamBuffer.h"
+#include "datatypes/MessageBuffer.h"
 #include "datatypes/Stack.h"
+#include "datatypes/Pool.h"
 
 #endif
 
@@ -16,12 +16,110 @@
 #include "ArdRTOS.h"
 #include <setjmp.h>
 #include <alloca.h>
+#include <limits.h>
 //! INCLUDES END
 
 __attribute__((weak)) void loop() {
     // you can use loop as a task if you so desire, but it has to be here somewhere
 }
 
+__attribute__((weak)) void osStackOverflow(TaskID t) {
+    // nothing can be trusted anymore, so stop here.
+    noInterrupts();
+    for (;;);
+}
+
+#if defined(__AVR__)
+#include <avr/sleep.h>
+
+// the interrupt mask and flag registers of timer0 are TIMSK0 and TIFR0 on most parts, but TIMSK and TIFR on older ATtinys
+#if defined(TIMSK0)
+#define TIMER0_MASK TIMSK0
+#define TIMER0_FLAGS TIFR0
+#elif defined(TIMSK)
+#define TIMER0_MASK TIMSK
+#define TIMER0_FLAGS TIFR
+#endif
+
+// microsecond sleepers get compare match B of timer2. timer0 cannot do it, since the core runs it in fast PWM mode,
+// where a new OCR0B only takes effect once it overflows, up to a millisecond later. in normal mode OCR2B takes effect
+// right away, but timer2 can no longer do PWM, so analogWrite() stops working on both of its pins (D3 and D11 on an Uno)
+// and tone() cannot be used.
+#if !defined(NO_US_TIMER) && defined(TCCR2A) && defined(TCCR2B) && defined(TIMSK2) && defined(OCR2B) && defined(TIMER2_COMPB_vect)
+#define US_TIMER
+#elif !defined(NO_US_TIMER)
+#warning "this part has no timer2, so delayMicroseconds() wakes on the next switch or millis() tick instead. define NO_US_TIMER to hide this"
+#endif
+
+__attribute__((weak)) void osIdle(unsigned long us) {
+    // timer0 overflows about every millisecond for millis(), and osTimerSet() gives timer2 a compare match
+    // for the next microsecond sleeper, so one of them always wakes us on time.
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    sleep_enable();
+    // the instruction after sei is always ran before any interrupt, so there is no chance to miss one before sleeping
+    sei();
+    sleep_cpu();
+    sleep_disable();
+    cli();
+}
+
+#ifdef US_TIMER
+__attribute__((weak)) void osTimerSet(unsigned long us) {
+    static bool started = false;
+    if (!started) {
+        // normal mode, counting every 64 clocks like timer0 does for millis(). it overflows about every millisecond.
+        TCCR2A = 0;
+        TCCR2B = 1 << CS22;
+        started = true;
+    }
+    if (us == WAIT_FOREVER) {
+        TIMSK2 &= ~(1 << OCIE2B);
+        return;
+    }
+    // rounding up means it never goes off before the task is due
+    unsigned long ticks = us < 0x10000 ? (us * clockCyclesPerMicrosecond() + 63) / 64 : 0xFF;
+    // a match on the count the timer is already at, or is about to move past, would wait for it to come all the way back around
+    if (ticks < 2) {
+        ticks = 2;
+    }
+    // anything further than one trip around goes off early, and Scheduler::timerFromISR() just sets it again
+    if (ticks > 0xFF) {
+        ticks = 0xFF;
+    }
+    OCR2B = TCNT2 + (uint8_t)ticks;
+    TIFR2 = 1 << OCF2B;
+    TIMSK2 |= 1 << OCIE2B;
+}
+#else
+__attribute__((weak)) void osTimerSet(unsigned long us) {
+    // no timer to spare. microsecond sleepers are woken by nextTask() checking micros() instead,
+    // which happens at the latest on the next overflow of timer0 when idle.
+}
+#endif
+#elif defined(__arm__)
+__attribute__((weak)) void osIdle(unsigned long us) {
+    // a pending interrupt wakes wfi even while they are masked. it gets handled once they are enabled.
+    __asm__ __volatile__ ("wfi");
+    interrupts();
+    noInterrupts();
+}
+
+__attribute__((weak)) void osTimerSet(unsigned long us) {
+    // no timer to spare here. microsecond sleepers are woken by nextTask() checking micros() instead.
+}
+#else
+__attribute__((weak)) void osIdle(unsigned long us) {
+    // no way to sleep here, so just let interrupts through so that millis() and micros() keep counting.
+    interrupts();
+    __asm__ __volatile__ ("nop");
+    noInterrupts();
+}
+
+__attribute__((weak)) void osTimerSet(unsigned long us) {
+    // no timer to spare here. microsecond sleepers are woken by nextTask() checking micros() instead.
+}
+#endif
+
 /**
  ######   ##        #######  ########     ###    ##        ######
 ##    ##  ##       ##     ## ##     ##   ## ##   ##       ##    ##
@@ -34,24 +132,184 @@ __attribute__((weak)) void loop() {
 
 Scheduler OS;
 
+#ifdef PREEMPTIVE
+#if defined(SETJMP_SWITCH) || !defined(__AVR__)
+#error "PREEMPTIVE needs the hand written context switcher, which only AVR has a tick ISR for so far"
+#endif
+// what the tick ISR pushes before it gets to osSwitch(): r0, SREG, r1, RAMPZ, r18-r27, r30 and r31,
+// two return addresses, and whatever osPreempt() and nextTask() need on top of that.
+#define PREEMPT_SIZE 48
+#else
+#define PREEMPT_SIZE 0
+#endif
+
+#ifdef ARDRTOS_HOST
+// code built for a pc needs far more stack than the same code on a microcontroller
+#define HOST_SIZE ARDRTOS_HOST_STACK
+#else
+#define HOST_SIZE 0
+#endif
+
+#if defined(SETJMP_SWITCH)
+// the jmp_buf lives in the task, but the stack still needs room for whatever setjmp and longjmp push
+#define CONTEXT_SIZE sizeof(jmp_buf)
+#define STACK_ALIGN 1
+#elif defined(__AVR__)
+// r2-r17, r28 and r29 plus a return address of up to 3 bytes
+#define CONTEXT_SIZE (18 + 3)
+#define STACK_ALIGN 1
+#elif defined(__ARM_FP) || (defined(__VFP_FP__) && !defined(__SOFTFP__))
+// there is an fpu, so the compiler keeps floats in s16-s31 even when the softfp ABI passes them in core registers.
+// what matters is whether the fpu is used, not how floats are passed.
+#define SAVE_FPU
+// r4-r11 and lr, plus s16-s31
+#define CONTEXT_SIZE ((9 + 16) * 4)
+// the ABI wants the stack 8 byte aligned
+#define STACK_ALIGN 8
+#else
+// r4-r11 and lr
+#define CONTEXT_SIZE (9 * 4)
+#define STACK_ALIGN 8
+#endif
+
 struct _TASK {
     // the function pointer to call
     osFuncCall fc;
     // the arg to pass if it exists. note, it must be a single void pointer, but
     // it can be filled with a class, struct, or basic type if you want. 
     void* arg;
-    // stack size. this is used at the begining to set up the OS and for detecting stack overflow (future)
+    // stack size. this is used at the begining to set up the OS and for detecting stack overflow
     unsigned ss;
+    // the lowest address of the tasks stack. the canary sits here and the painted area starts right above it.
+    // 0 until begin() hands one out, unless one was given to addTask().
+    uint8_t* stack;
+#ifdef SETJMP_SWITCH
     // the jump buffer used to store cpu context and restore execution.
     jmp_buf jb;
+#else
+    // the stack pointer of the task while it is switched out. the rest of its context is pushed onto its own stack.
+    void* sp;
+#endif
+    // the time the task should wake up at. only valid while the task is sleeping.
+    unsigned long wake;
+    // the next task in whichever sleeping list this task is on. NO_TASK marks the end of the list.
+    TaskID next;
+    // what the task is currently doing. see TASK_* below.
+    uint8_t state;
+    // the next task in the WaitList this task is blocked on.
+    TaskID waitNext;
+    // set when the task stopped waiting because it ran out of time instead of being woken.
+    bool timedOut;
+    // the WaitList this task is blocked on. only valid while TASK_WAITING is set.
+    WaitList* waitingOn;
+    // the value handed over by notify(). reset to 0 each time waitNotify() takes it.
+    unsigned long notifyValue;
+    // set by notify() until waitNotify() sees it
+    bool notified;
+    // the task itself while it is blocked in waitNotify()
+    WaitList notifyWait;
+#ifndef NO_PRIORITIES
+    // the priority the task runs at. used to pick which ready mask the task lives in.
+    // higher than base while a task waiting on a Mutex it holds lends it theirs.
+    Priority prio;
+    // the priority the task was given
+    Priority base;
+    // the Mutexes the task holds, last taken first, threaded through Mutex::_nextHeld
+    Mutex* held;
+#endif
+#ifdef TASK_STATS
+    // how much processor time the task has used, how often it was switched in and its longest single run.
+    TaskStats stats;
+#endif
+    // where the task is in periodics, or NO_TASK if it was not added with addPeriodicTask()
+    uint8_t periodic;
 } tasks[ARDRTOS_TASK_COUNT];
 
+// the schedule of a task added with addPeriodicTask()
+struct Periodic {
+    // how often the task is released in microseconds
+    unsigned long period;
+    // when the task was last released in microseconds. holds the offset until begin() adds the time it started at.
+    unsigned long release;
+    PeriodicStats stats;
+} periodics[ARDRTOS_PERIODIC_COUNT];
+
+// the number of periodic tasks
+uint8_t nump = 0;
+
+// the task can be switched to
+#define TASK_READY 0
+// the task is waiting in msSleepers for millis() to pass its wake time
+#define TASK_SLEEP_MS 1
+// the task is waiting in usSleepers for micros() to pass its wake time
+#define TASK_SLEEP_US 2
+// the task is blocked in a WaitList. this can be combined with TASK_SLEEP_MS for a timeout.
+#define TASK_WAITING 4
+
+// what unused stack is painted with so the high water mark can be found later
+#define STACK_PAINT 0xA5
+// what sits at the very bottom of each stack. if this changes, the task has overflown its stack.
+#define STACK_CANARY ((unsigned)0xC0DEFACEUL)
+
 // the current task
 volatile uint8_t curr = 0;
 
 // the number of tasks
 volatile uint8_t numt = 0;
 
+// sleeping tasks sorted by their wake time, soonest first.
+// there is one list per time base so that neither one has to be converted into the other.
+TaskID msSleepers = NO_TASK;
+TaskID usSleepers = NO_TASK;
+
+// how long every task has been asleep in total, in microseconds
+unsigned long idleTime = 0;
+
+// how many times osIdle() returned without any task being ready to run
+unsigned long spuriousWakeups = 0;
+
+// how many times suspendPreemption() has been called without a matching resumePreemption()
+volatile uint8_t preemptLock = 0;
+
+#ifdef PREEMPTIVE
+// set when a tick wanted to switch tasks while preemption was suspended
+volatile bool preemptPending = false;
+
+// set while nextTask() is in osIdle() with interrupts enabled, so that a tick does not try to schedule on top of it
+volatile bool idling = false;
+#endif
+
+#ifdef TASK_STATS
+// how many times any task was switched in
+unsigned long totalSwitches = 0;
+
+// when the current task was switched in, in microseconds
+unsigned long switchedIn = 0;
+#endif
+
+#ifndef NO_PRIORITIES
+#if ARDRTOS_PRIORITY_COUNT > 8
+#error "ARDRTOS_PRIORITY_COUNT can be at most 8"
+#endif
+
+// one bit per task, wide enough for all of them
+#if ARDRTOS_TASK_COUNT <= 8
+typedef uint8_t TaskMask;
+#elif ARDRTOS_TASK_COUNT <= 16
+typedef uint16_t TaskMask;
+#elif ARDRTOS_TASK_COUNT <= 32
+typedef uint32_t TaskMask;
+#else
+#error "ARDRTOS_TASK_COUNT can be at most 32 unless NO_PRIORITIES is defined"
+#endif
+
+// the ready tasks at each priority. bit n is set when task n is ready.
+TaskMask readyTasks[ARDRTOS_PRIORITY_COUNT];
+
+// bit p is set when readyTasks[p] is not empty
+uint8_t readyPrios = 0;
+#endif
+
 /**
  ######   #######  ##    ## ######## ######## ##     ## ########     ######  ##      ## #### ########  ######  ##     ## ######## ########
 ##    ## ##     ## ###   ##    ##    ##        ##   ##     ##       ##    ## ##  ##  ##  ##     ##    ##    ## ##     ## ##       ##     ##
@@ -62,16 +320,624 @@ volatile uint8_t numt = 0;
  ######   #######  ##    ##    ##    ######## ##     ##    ##        ######   ###  ###  ####    ##     ######  ##     ## ######## ##     ##
 */
 
+#ifndef NO_PRIORITIES
+/**
+ * @brief finds the highest set bit in constant time. 
+ * a lookup is used over __builtin_clz because avr does not have an instruction for it.
+ * 
+ * @param m the mask to search. must not be 0.
+ * @return uint8_t the index of the highest set bit
+ */
+static uint8_t highestBit(TaskMask m) {
+    static const uint8_t nibble[16] = {0, 0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3};
+    uint8_t b = 0;
+#if ARDRTOS_TASK_COUNT > 16
+    if (m & 0xFFFF0000) { m >>= 16; b += 16; }
+#endif
+#if ARDRTOS_TASK_COUNT > 8
+    if (m & 0xFF00) { m >>= 8; b += 8; }
+#endif
+    if (m & 0xF0) { m >>= 4; b += 4; }
+    return b + nibble[m];
+}
+#endif
+
+/**
+ * @brief marks a task as ready to be switched to.
+ * interrupts must be dissabled before calling this.
+ * 
+ * @param t the task to mark as ready
+ */
+static inline void readyAdd(TaskID t) {
+    tasks[t].state = TASK_READY;
+#ifndef NO_PRIORITIES
+    readyTasks[tasks[t].prio] |= (TaskMask)1 << t;
+    readyPrios |= 1 << tasks[t].prio;
+#endif
+}
+
+/**
+ * @brief takes a task out of the running so it will not be switched to.
+ * interrupts must be dissabled before calling this.
+ * 
+ * @param t the task to remove
+ * @param state what the task is doing instead
+ */
+static inline void readyRemove(TaskID t, uint8_t state) {
+    tasks[t].state = state;
+#ifndef NO_PRIORITIES
+    Priority p = tasks[t].prio;
+    readyTasks[p] &= ~((TaskMask)1 << t);
+    if (readyTasks[p] == 0) {
+        readyPrios &= ~(1 << p);
+    }
+#endif
+}
+
+/**
+ * @brief puts the current task into a sleeping list, keeping the list sorted by wake time.
+ * interrupts must be dissabled before calling this. 
+ * 
+ * @param list the head of the list to insert into
+ * @param wake the time to wake up at in the lists time base
+ */
+static void sleepInsert(TaskID &list, unsigned long wake) {
+    TaskID *n = &list;
+    // wake times are compared by their signed difference so that the lists survive millis() and micros() rolling over
+    while (*n != NO_TASK && (long)(wake - tasks[*n].wake) >= 0) {
+        n = &tasks[*n].next;
+    }
+    tasks[curr].wake = wake;
+    tasks[curr].next = *n;
+    *n = curr;
+}
+
+/**
+ * @brief takes a task out of the middle of a sleeping list. used when a task is woken before its timeout.
+ * interrupts must be dissabled before calling this.
+ * 
+ * @param list the head of the list the task is in
+ * @param t the task to remove
+ */
+static void sleepRemove(TaskID &list, TaskID t) {
+    TaskID *n = &list;
+    while (*n != t) {
+        n = &tasks[*n].next;
+    }
+    *n = tasks[t].next;
+}
+
+/**
+ * @brief takes a task out of the WaitList it is blocked on.
+ * interrupts must be dissabled before calling this.
+ * 
+ * @param t the task to remove
+ */
+static void waitRemove(TaskID t) {
+    TaskID *n = &tasks[t].waitingOn->head;
+    while (*n != t) {
+        n = &tasks[*n].waitNext;
+    }
+    *n = tasks[t].waitNext;
+}
+
+/**
+ * @brief marks every task at the front of the list whose wake time has passed as ready.
+ * since the list is sorted, this stops at the first task that still has to sleep.
+ * 
+ * @param list the head of the list to wake tasks from
+ * @param now the current time in the lists time base
+ */
+static void sleepWake(TaskID &list, unsigned long now) {
+    while (list != NO_TASK && (long)(now - tasks[list].wake) >= 0) {
+        TaskID t = list;
+        list = tasks[t].next;
+        if (tasks[t].state & TASK_WAITING) {
+            // this was a timeout. stop waiting on whatever the task was waiting on.
+            waitRemove(t);
+            tasks[t].timedOut = true;
+        }
+        readyAdd(t);
+    }
+}
+
+/**
+ * @brief points osTimerSet() at the first microsecond sleeper. called whenever the front of usSleepers changes.
+ * interrupts must be dissabled before calling this.
+ */
+static void usTimerUpdate() {
+    if (usSleepers == NO_TASK) {
+        osTimerSet(WAIT_FOREVER);
+        return;
+    }
+    long us = tasks[usSleepers].wake - micros();
+    osTimerSet(us > 0 ? us : 0);
+}
+
+/**
+ * @brief works out how long it is until the first sleeping task is due.
+ * interrupts must be dissabled before calling this.
+ * 
+ * @return unsigned long the time until a task is due in microseconds, or WAIT_FOREVER if none are sleeping
+ */
+static unsigned long idleFor() {
+    unsigned long us = WAIT_FOREVER;
+    if (msSleepers != NO_TASK) {
+        long ms = tasks[msSleepers].wake - millis();
+        if (ms <= 0) {
+            return 0;
+        }
+        // sleeping less than asked is fine. osIdle() will just be called again.
+        us = (unsigned long)ms < WAIT_FOREVER / 1000 ? ms * 1000 : WAIT_FOREVER - 1;
+    }
+    if (usSleepers != NO_TASK) {
+        long u = tasks[usSleepers].wake - micros();
+        if (u <= 0) {
+            return 0;
+        }
+        if ((unsigned long)u < us) {
+            us = u;
+        }
+    }
+    return us;
+}
+
+/**
+ * @brief finds the next task to run, skipping over sleeping tasks.
+ * the highest priority that has a ready task is picked, and tasks within that priority take turns in round robin order.
+ * if every task is asleep, this calls osIdle() until one of them wakes up.
+ * interrupts must be dissabled before calling this.
+ * 
+ * @return TaskID the task to switch to
+ */
+static TaskID nextTask() {
+#ifdef NO_PRIORITIES
+    TaskID n = curr;
+#endif
+    bool idled = false;
+    for (;;) {
+        if (msSleepers != NO_TASK) sleepWake(msSleepers, millis());
+        if (usSleepers != NO_TASK) {
+            TaskID first = usSleepers;
+            sleepWake(usSleepers, micros());
+            if (usSleepers != first) {
+                usTimerUpdate();
+            }
+        }
+
+#ifdef NO_PRIORITIES
+        // the current task is checked last so that everyone else gets a turn first
+        for (uint8_t i = 0; i <= numt; i++) {
+            if (n == 0) {
+                n = numt;
+            } else {
+                n--;
+            }
+            if (tasks[n].state == TASK_READY) {
+                return n;
+            }
+        }
+#else
+        if (readyPrios != 0) {
+            TaskMask m = readyTasks[highestBit(readyPrios)];
+            // same order as the round robin: the next lowest task first, wrapping back around to the top.
+            TaskMask below = m & (((TaskMask)1 << curr) - 1);
+            return highestBit(below != 0 ? below : m);
+        }
+#endif
+
+        // nothing can run. sleep until the next task is due or an interrupt wakes one up.
+        if (idled) {
+            spuriousWakeups++;
+        }
+        unsigned long start = micros();
+#ifdef PREEMPTIVE
+        idling = true;
+#endif
+        osIdle(idleFor());
+#ifdef PREEMPTIVE
+        idling = false;
+#endif
+        idleTime += micros() - start;
+        idled = true;
+    }
+}
+
+#ifdef TASK_STATS
+/**
+ * @brief adds the time since the current task was switched in to its stats.
+ * interrupts must be dissabled before calling this.
+ */
+static void statsSwitchOut() {
+    unsigned long ran = micros() - switchedIn;
+    tasks[curr].stats.runTime += ran;
+    if (ran > tasks[curr].stats.longestRun) {
+        tasks[curr].stats.longestRun = ran;
+    }
+}
+
+/**
+ * @brief counts the current task being switched in and starts timing it.
+ * this is done after nextTask() so that time spent idle is not charged to anyone.
+ * interrupts must be dissabled before calling this.
+ */
+static void statsSwitchIn() {
+    tasks[curr].stats.switches++;
+    totalSwitches++;
+    switchedIn = micros();
+}
+#endif
+
+/**
+ * @brief runs the current task once per release forever. it is switched in right as it is released.
+ */
+__attribute__((noreturn)) static void periodicRun() {
+    Periodic &p = periodics[tasks[curr].periodic];
+    osFuncCall job = tasks[curr].fc;
+    while (true) {
+        unsigned long late = micros() - p.release;
+        job();
+        unsigned long now = micros();
+        unsigned long response = now - p.release;
+
+        noInterrupts();
+        p.stats.releases++;
+        if (late > p.stats.maxJitter) {
+            p.stats.maxJitter = late;
+        }
+        if (response > p.stats.worstResponse) {
+            p.stats.worstResponse = response;
+        }
+        p.release += p.period;
+        if ((long)(now - p.release) > 0) {
+            // it finished after its deadline, which is the next release
+            p.stats.overruns++;
+            // any release whose deadline has passed too is skipped, so the task does not run back to back to catch up
+            while (now - p.release >= p.period) {
+                p.release += p.period;
+                p.stats.overruns++;
+            }
+        }
+        interrupts();
+
+        OS.delayUntilMicroseconds(p.release);
+    }
+}
+
+/**
+ * @brief runs the current tasks loop function forever. every task starts here the first time it is switched to.
+ */
+__attribute__((noreturn)) static void taskRun() {
+    interrupts();
+    if (tasks[curr].periodic != NO_TASK) {
+        periodicRun();
+    }
+    if (tasks[curr].arg != 0){
+        // slight optimization since curr will be the same for this task for the rest of time.
+        osFuncCallArg t = (osFuncCallArg)tasks[curr].fc;
+        void* a = tasks[curr].arg;
+        while (true) {
+            t(a);
+            OS.yield();
+        }
+    } else {
+        while (true) {
+            tasks[curr].fc();
+            OS.yield();
+        }
+    }
+}
+
+#ifdef SETJMP_SWITCH
+// begin() already saved a context for every task with setjmp
+static inline void contextInit(TaskID t) {}
+
+/**
+ * @brief switches to another task. the current task has to have been saved with setjmp beforehand.
+ * interrupts must be dissabled before calling this.
+ * 
+ * @param from the task being switched out
+ * @param to the task to switch to
+ */
+static inline void contextSwitch(TaskID from, TaskID to) {
+    longjmp(tasks[to].jb, 1);
+}
+
+/**
+ * @brief switches to the first task. this never returns.
+ * 
+ * @param to the task to start with
+ */
+__attribute__((noreturn)) static inline void contextStart(TaskID to) {
+    longjmp(tasks[to].jb, 1);
+}
+#else
+/**
+ * @brief pushes the callee saved registers onto the current stack, saves the stack pointer into save,
+ * then loads the stack pointer from load and pops the other tasks registers back off of it.
+ * everything else was already saved by the compiler because this is a function call.
+ * interrupts must be dissabled before calling this.
+ * 
+ * @param save where to store the stack pointer of the task being switched out
+ * @param load the stack pointer of the task to switch to
+ */
+__attribute__((naked, noinline)) static void osSwitch(void** save, void* load) {
+#if defined(__AVR__)
+    // save arrives in r25:r24 and load in r23:r22. r18, r19, r30 and r31 are free to use.
+    __asm__ __volatile__ (
+        "push r2\n\t"  "push r3\n\t"  "push r4\n\t"  "push r5\n\t"
+        "push r6\n\t"  "push r7\n\t"  "push r8\n\t"  "push r9\n\t"
+        "push r10\n\t" "push r11\n\t" "push r12\n\t" "push r13\n\t"
+        "push r14\n\t" "push r15\n\t" "push r16\n\t" "push r17\n\t"
+        "push r28\n\t" "push r29\n\t"
+        "movw r30, r24\n\t"
+        "in r18, __SP_L__\n\t"
+        "in r19, __SP_H__\n\t"
+        "st Z, r18\n\t"
+        "std Z+1, r19\n\t"
+        "out __SP_H__, r23\n\t"
+        "out __SP_L__, r22\n\t"
+        "pop r29\n\t"  "pop r28\n\t"
+        "pop r17\n\t"  "pop r16\n\t"  "pop r15\n\t"  "pop r14\n\t"
+        "pop r13\n\t"  "pop r12\n\t"  "pop r11\n\t"  "pop r10\n\t"
+        "pop r9\n\t"   "pop r8\n\t"   "pop r7\n\t"   "pop r6\n\t"
+        "pop r5\n\t"   "pop r4\n\t"   "pop r3\n\t"   "pop r2\n\t"
+        "ret\n\t"
+    );
+#else
+    // save arrives in r0 and load in r1. r8-r11 go through r4-r7 so that this also runs on thumb-1 only cores like the M0.
+    __asm__ __volatile__ (
+        "push {r4-r7, lr}\n\t"
+        "mov r4, r8\n\t"
+        "mov r5, r9\n\t"
+        "mov r6, r10\n\t"
+        "mov r7, r11\n\t"
+        "push {r4-r7}\n\t"
+#ifdef SAVE_FPU
+        "vpush {s16-s31}\n\t"
+#endif
+        "mov r2, sp\n\t"
+        "str r2, [r0]\n\t"
+        "mov sp, r1\n\t"
+#ifdef SAVE_FPU
+        "vpop {s16-s31}\n\t"
+#endif
+        "pop {r4-r7}\n\t"
+        "mov r8, r4\n\t"
+        "mov r9, r5\n\t"
+        "mov r10, r6\n\t"
+        "mov r11, r7\n\t"
+        "pop {r4-r7, pc}\n\t"
+    );
+#endif
+}
+
+/**
+ * @brief lays out a context at the top of a tasks stack that osSwitch() will "return" into taskRun() from.
+ * the registers all start out as 0.
+ * 
+ * @param t the task to set up
+ */
+static void contextInit(TaskID t) {
+    uint8_t* top = tasks[t].stack + tasks[t].ss;
+#if defined(__AVR__)
+    // push post decrements, so the stack pointer always points at the next free byte
+    uint8_t* sp = top - 1;
+    uint16_t pc = (uint16_t)taskRun;
+    // ret pops the high byte first
+    *sp-- = pc & 0xFF;
+    *sp-- = pc >> 8;
+#ifdef __AVR_3_BYTE_PC__
+    *sp-- = 0;
+#endif
+    for (uint8_t r = 0; r < 18; r++) {
+        *sp-- = 0;
+    }
+#else
+    uint32_t* sp = (uint32_t*)((uintptr_t)top & ~(uintptr_t)(STACK_ALIGN - 1));
+    // popped into pc last. the thumb bit is already set in the function pointer.
+    *--sp = (uint32_t)taskRun;
+    for (uint8_t r = 0; r < (CONTEXT_SIZE / 4) - 1; r++) {
+        *--sp = 0;
+    }
+#endif
+    tasks[t].sp = sp;
+}
+
+/**
+ * @brief switches from one task to another. returns once the from task is switched back in.
+ * interrupts must be dissabled before calling this.
+ * 
+ * @param from the task being switched out
+ * @param to the task to switch to
+ */
+static inline void contextSwitch(TaskID from, TaskID to) {
+    if (from != to) {
+        osSwitch(&tasks[from].sp, tasks[to].sp);
+    }
+}
+
+/**
+ * @brief switches to the first task. this never returns.
+ * 
+ * @param to the task to start with
+ */
+__attribute__((noreturn)) static void contextStart(TaskID to) {
+    // the stack begin() was called on is never used again
+    void* sp;
+    osSwitch(&sp, tasks[to].sp);
+    for (;;);
+}
+#endif
+
+/**
+ * @brief switches to whichever task should run next. returns once the current task is switched back in.
+ * interrupts must be dissabled before calling this.
+ */
+static void schedule() {
+#ifndef NO_STACK_CHECK
+    if (*(unsigned*)tasks[curr].stack != STACK_CANARY) {
+        osStackOverflow(curr);
+    }
+#endif
+    TaskID from = curr;
+#ifdef TASK_STATS
+    statsSwitchOut();
+#endif
+    TaskID to = nextTask();
+#ifdef TASK_TRACE
+    if (to != from) {
+        TRACE_FROM_ISR(TRACE_SWITCH, to);
+    }
+#endif
+    curr = to;
+#ifdef TASK_STATS
+    statsSwitchIn();
+#endif
+    contextSwitch(from, curr);
+}
+
 void Scheduler::yield() {
     noInterrupts();
-    if (setjmp(tasks[curr].jb) == 0) {
-        if (curr == 0) {
-            curr = numt;
-        } else {
-            curr--;
-        }
-        longjmp(tasks[curr].jb, 1);
+#ifdef SETJMP_SWITCH
+    if (setjmp(tasks[curr].jb) != 0) {
+        // switched back in
+        interrupts();
+        return;
     }
+#endif
+#ifdef PREEMPTIVE
+    preemptPending = false;
+#endif
+    schedule();
+    interrupts();
+}
+
+#ifdef PREEMPTIVE
+/**
+ * @brief called by the tick ISR once it has saved everything the compiler does not save for it.
+ * the current task is always ready here, so nextTask() never has to idle. tasks at the same priority take turns
+ * every tick, and a higher priority task that woke up is switched to right away.
+ */
+extern "C" __attribute__((used)) void osPreempt() {
+    if (idling) {
+        // the scheduler is already looking for something to run
+        return;
+    }
+    if (preemptLock != 0) {
+        preemptPending = true;
+        return;
+    }
+    schedule();
+}
+
+#ifdef __AVR_HAVE_RAMPZ__
+#define PUSH_RAMPZ "in r0, __RAMPZ__\n\t" "push r0\n\t"
+#define POP_RAMPZ "pop r0\n\t" "out __RAMPZ__, r0\n\t"
+#else
+#define PUSH_RAMPZ
+#define POP_RAMPZ
+#endif
+
+#ifdef __AVR_HAVE_JMP_CALL__
+#define CALL_INSN "call "
+#else
+#define CALL_INSN "rcall "
+#endif
+
+/**
+ * @brief defines an ISR that may switch tasks by calling handler. it is naked so that the whole context of the task
+ * it interrupted ends up on that tasks stack: the registers a function call may change are pushed here,
+ * and osSwitch() pushes the rest. when the task is switched back in, it picks up right where it was interrupted.
+ */
+#define PREEMPT_ISR(vector, handler) \
+    ISR(vector, ISR_NAKED) { \
+        __asm__ __volatile__ ( \
+            "push r0\n\t" \
+            "in r0, __SREG__\n\t" \
+            "push r0\n\t" \
+            "push r1\n\t" \
+            "clr r1\n\t" \
+            PUSH_RAMPZ \
+            "push r18\n\t" "push r19\n\t" "push r20\n\t" "push r21\n\t" \
+            "push r22\n\t" "push r23\n\t" "push r24\n\t" "push r25\n\t" \
+            "push r26\n\t" "push r27\n\t" "push r30\n\t" "push r31\n\t" \
+            CALL_INSN #handler "\n\t" \
+            "pop r31\n\t"  "pop r30\n\t"  "pop r27\n\t"  "pop r26\n\t" \
+            "pop r25\n\t"  "pop r24\n\t"  "pop r23\n\t"  "pop r22\n\t" \
+            "pop r21\n\t"  "pop r20\n\t"  "pop r19\n\t"  "pop r18\n\t" \
+            POP_RAMPZ \
+            "pop r1\n\t" \
+            "pop r0\n\t" \
+            "out __SREG__, r0\n\t" \
+            "pop r0\n\t" \
+            "reti\n\t" \
+        ); \
+    }
+
+// the tick
+PREEMPT_ISR(ARDRTOS_TICK_VECTOR, osPreempt)
+
+__attribute__((weak)) void osTickSetup() {
+    // timer0 already runs for millis(). a compare match on it fires once per overflow, about every millisecond.
+    OCR0A = 0x80;
+    TIMER0_FLAGS = 1 << OCF0A;
+    TIMER0_MASK |= 1 << OCIE0A;
+}
+#endif
+
+void Scheduler::timerFromISR() {
+    if (usSleepers != NO_TASK) {
+        sleepWake(usSleepers, micros());
+    }
+    usTimerUpdate();
+}
+
+#ifdef US_TIMER
+#ifdef PREEMPTIVE
+/**
+ * @brief called by the compare match from osTimerSet(). if the task that just woke up outranks the current one,
+ * it is switched to right away instead of waiting for the next tick.
+ */
+extern "C" __attribute__((used)) void osTimerPreempt() {
+    Scheduler::timerFromISR();
+#ifndef NO_PRIORITIES
+    if (idling || (readyPrios >> (tasks[curr].prio + 1)) == 0) {
+        return;
+    }
+    if (preemptLock != 0) {
+        preemptPending = true;
+        return;
+    }
+    schedule();
+#endif
+}
+
+PREEMPT_ISR(TIMER2_COMPB_vect, osTimerPreempt)
+#else
+ISR(TIMER2_COMPB_vect) {
+    Scheduler::timerFromISR();
+}
+#endif
+#endif
+
+void Scheduler::suspendPreemption() {
+    noInterrupts();
+    preemptLock++;
+    interrupts();
+}
+
+void Scheduler::resumePreemption() {
+    noInterrupts();
+    preemptLock--;
+#ifdef PREEMPTIVE
+    if (preemptLock == 0 && preemptPending) {
+        // a tick was skipped, so make up for it now
+        interrupts();
+        yield();
+        return;
+    }
+#endif
     interrupts();
 }
 
@@ -88,59 +954,214 @@ void Scheduler::yield() {
 Scheduler::Scheduler() {
 }
 
-void Scheduler::addTask(osFuncCall loop, unsigned stackSize) {
+void Scheduler::addTask(osFuncCall loop, unsigned stackSize, Priority priority) {
     //grab the value of numt and store it
     unsigned char n = numt;
     // save the pointer to the function to loop over
     tasks[n].fc = loop;
     tasks[n].arg = (void*)0;
+    tasks[n].periodic = NO_TASK;
     // save how big you want the stack to be
-    tasks[n].ss = stackSize + _JBLEN;
+    tasks[n].ss = (stackSize + CONTEXT_SIZE + PREEMPT_SIZE + HOST_SIZE + STACK_ALIGN - 1) & ~(STACK_ALIGN - 1);
+#ifndef NO_PRIORITIES
+    if (priority >= ARDRTOS_PRIORITY_COUNT) {
+        priority = ARDRTOS_PRIORITY_COUNT - 1;
+    }
+    tasks[n].prio = priority;
+    tasks[n].base = priority;
+    tasks[n].held = 0;
+#endif
+    readyAdd(n);
 
     // increment numt
     numt = n + 1;
 }
 
-void Scheduler::addTask(osFuncCallArg loop, void *arg, unsigned stackSize) {
-    addTask((osFuncCall)loop, stackSize);
+void Scheduler::addTask(osFuncCallArg loop, void *arg, unsigned stackSize, Priority priority) {
+    addTask((osFuncCall)loop, stackSize, priority);
+    setTaskArg(arg);
+}
+
+void Scheduler::addTaskStatic(osFuncCall loop, uint8_t* stack, unsigned stackSize, Priority priority) {
+    addTask(loop, 0, priority);
+    // the canary at the bottom and the context at the top both need the stack to be aligned.
+    // with SETJMP_SWITCH, begin() replaces the stack with one of the same size anyways.
+    uint8_t* s = (uint8_t*)(((uintptr_t)stack + STACK_ALIGN - 1) & ~(uintptr_t)(STACK_ALIGN - 1));
+    tasks[numt-1].stack = s;
+    tasks[numt-1].ss = (stackSize - (s - stack)) & ~(STACK_ALIGN - 1);
+#ifdef ARDRTOS_HOST
+    // setjmp is always used on a pc, so the array is never actually used
+    tasks[numt-1].ss += HOST_SIZE;
+#endif
+}
+
+void Scheduler::setTaskArg(void* arg) {
     tasks[numt-1].arg = arg;
 }
 
+void Scheduler::addPeriodicTask(osFuncCall job, unsigned long periodUs, unsigned long offsetUs, unsigned stackSize, Priority priority) {
+    if (nump >= ARDRTOS_PERIODIC_COUNT) {
+        return;
+    }
+    // releases are checked with a signed difference, so anything 2^31 or longer would look like it is already late
+    if (periodUs >= 0x80000000UL || offsetUs >= 0x80000000UL) {
+        return;
+    }
+    addTask(job, stackSize, priority);
+    Periodic &p = periodics[nump];
+    p.period = periodUs == 0 ? 1 : periodUs;
+    p.release = offsetUs;
+    tasks[numt-1].periodic = nump;
+    nump++;
+}
+
+PeriodicStats Scheduler::getPeriodicStats(TaskID t) {
+    PeriodicStats s = {0, 0, 0, 0};
+    noInterrupts();
+    if (tasks[t].periodic != NO_TASK) {
+        s = periodics[tasks[t].periodic].stats;
+    }
+    interrupts();
+    return s;
+}
+
+void Scheduler::resetPeriodicStats(TaskID t) {
+    noInterrupts();
+    if (tasks[t].periodic != NO_TASK) {
+        PeriodicStats s = {0, 0, 0, 0};
+        periodics[tasks[t].periodic].stats = s;
+    }
+    interrupts();
+}
+
+/**
+ * @brief paints every stack, sets up the first context of every task and switches to the first one to run.
+ * the stacks have to have been handed out to the tasks already.
+ */
+__attribute__((noreturn)) static void startTasks() {
+    // every periodic task is released relative to now
+    unsigned long start = micros();
+    // paint every stack so getStackHighWater() can tell how much was used, and put a canary at the bottom of each.
+    for (curr = 0; curr < numt; curr++) {
+        memset(tasks[curr].stack, STACK_PAINT, tasks[curr].ss);
+        *(unsigned*)tasks[curr].stack = STACK_CANARY;
+        contextInit(curr);
+
+        if (tasks[curr].periodic != NO_TASK) {
+            // it sleeps until its first release
+            Periodic &p = periodics[tasks[curr].periodic];
+            p.release += start;
+            readyRemove(curr, TASK_SLEEP_US);
+            sleepInsert(usSleepers, p.release);
+        }
+    }
+    usTimerUpdate();
+
+    // write to memory
+    numt = numt-1;
+    curr = 0;
+#ifndef NO_PRIORITIES
+    // start with the highest priority task instead of whichever was added first
+    curr = nextTask();
+#else
+    if (tasks[curr].state != TASK_READY) {
+        // the first task is periodic and has not been released yet
+        curr = nextTask();
+    }
+#endif
+
+#ifdef TASK_STATS
+    statsSwitchIn();
+#endif
+
+#ifdef PREEMPTIVE
+    // interrupts stay off until the first task starts
+    osTickSetup();
+#endif
+
+    // start the OS
+    contextStart(curr);
+}
+
+#ifdef __AVR__
+// where malloc() has grown the heap up to, or 0 if it has not been used yet
+extern char* __brkval;
+#endif
+
+/**
+ * @brief keeps malloc() out of the stacks carved out of the main stack. avr-libc lets the heap grow up to a little below
+ * the stack pointer unless __malloc_heap_end says otherwise, and once tasks run, that is the stack pointer of whichever
+ * task called malloc(), with the stacks of other tasks below it. does nothing off AVR.
+ * 
+ * @param bottom the lowest byte of the carved out stacks
+ */
+static void heapEndAt(uint8_t* bottom) {
+#ifdef __AVR__
+    char* top = __brkval != 0 ? __brkval : __malloc_heap_start;
+    if (top > (char*)bottom) {
+        // the heap is already using memory the stacks were carved out of
+        osStackOverflow(NO_TASK);
+    }
+    __malloc_heap_end = (char*)bottom;
+#endif
+}
+
+#ifdef SETJMP_SWITCH
 // NOOP is justified because alloca will be whisked away if we dont, and we dont want that.
 __ATTR_NORETURN__ NOOP void Scheduler::begin() {
     // transfer from describing how much space they want into 
     for(curr = 0; curr < numt; curr++) {
         // after initializing a stack, move up by the stack size you want
         if(curr != 0) {
-            alloca(tasks[curr-1].ss);
+            tasks[curr-1].stack = (uint8_t*)alloca(tasks[curr-1].ss);
         }
 
         if(setjmp(tasks[curr].jb) == 1) {
-            interrupts();
-            if (tasks[curr].arg != 0){
-                // slight optimization since curr will be the same for this task for the rest of time.
-                osFuncCallArg t = (osFuncCallArg)tasks[curr].fc;
-                void* a = tasks[curr].arg;
-                while (true) {
-                    t(a);
-                    OS.yield();
-                }
-            } else {
-                while (true) {
-                    tasks[curr].fc();
-                    OS.yield();
-                }
-            }
+            taskRun();
         }
     }
 
-    // write to memory
-    numt = numt-1;
-    curr = 0;
+    // the last task needs a stack too so it can be painted
+    tasks[curr-1].stack = (uint8_t*)alloca(tasks[curr-1].ss);
+    heapEndAt(tasks[curr-1].stack);
 
-    // start the OS
-    longjmp(tasks[0].jb, 1);
+    startTasks();
 }
+#else
+// NOOP keeps the alloca from being whisked away, the same as above.
+__ATTR_NORETURN__ NOOP void Scheduler::begin() {
+    // every stack that was not given to addTask() comes out of one block that is never freed,
+    // so there is nothing left to fragment.
+    unsigned total = 0;
+    for (curr = 0; curr < numt; curr++) {
+        if (tasks[curr].stack == 0) {
+            total += tasks[curr].ss;
+        }
+    }
+    if (total != 0) {
+#ifdef __AVR__
+        // on AVR the block is carved out of the main stack below us, which nothing uses once the first task starts.
+        // out of the heap, the stack pointer of every task would be inside the heap, and avr-libc's malloc() would refuse
+        // to hand out anything from a task.
+        uint8_t* mem = (uint8_t*)alloca(total);
+        heapEndAt(mem);
+#else
+        uint8_t* mem = (uint8_t*)malloc(total);
+        if (mem == 0) {
+            osStackOverflow(NO_TASK);
+        }
+#endif
+        for (curr = 0; curr < numt; curr++) {
+            if (tasks[curr].stack == 0) {
+                tasks[curr].stack = mem;
+                mem += tasks[curr].ss;
+            }
+        }
+    }
+
+    startTasks();
+}
+#endif
 
 /*
 ########  ######## ##          ###    ##    ##  ######
@@ -153,25 +1174,248 @@ __ATTR_NORETURN__ NOOP void Scheduler::begin() {
 */
 
 void Scheduler::delay(unsigned long ms) {
-    unsigned long calledTime = millis();
-    while (millis() - calledTime <= ms){
-        Scheduler::yield();
+    // wake times are compared by their signed difference, so really long delays have to be split up.
+    while (ms > LONG_MAX) {
+        delay(LONG_MAX);
+        ms -= LONG_MAX;
     }
+    delayUntil(millis() + ms);
 }
 
 void Scheduler::delayMicroseconds(unsigned long us) {
-    unsigned long calledTime = micros();
-    while (micros() - calledTime <= us){
-        Scheduler::yield();
+    while (us > LONG_MAX) {
+        delayMicroseconds(LONG_MAX);
+        us -= LONG_MAX;
     }
+    delayUntilMicroseconds(micros() + us);
 }
 
 void Scheduler::delayUntil(unsigned long ms) {
-    delay(ms-millis());
+    noInterrupts();
+    // the task stays out of the round robin until nextTask() sees that its time has come.
+    readyRemove(curr, TASK_SLEEP_MS);
+    sleepInsert(msSleepers, ms);
+    yield();
 }
 
 void Scheduler::delayUntilMicroseconds(unsigned long us) {
-    delayMicroseconds(us-micros());
+    noInterrupts();
+    readyRemove(curr, TASK_SLEEP_US);
+    sleepInsert(usSleepers, us);
+    if (usSleepers == curr) {
+        usTimerUpdate();
+    }
+    yield();
+}
+
+/*
+##      ##    ###    #### ######## #### ##    ##  ######
+##  ##  ##   ## ##    ##     ##     ##  ###   ## ##    ##
+##  ##  ##  ##   ##   ##     ##     ##  ####  ## ##
+##  ##  ## ##     ##  ##     ##     ##  ## ## ## ##   ####
+##  ##  ## #########  ##     ##     ##  ##  #### ##    ##
+##  ##  ## ##     ##  ##     ##     ##  ##   ### ##    ##
+ ###  ###  ##     ## ####    ##    #### ##    ##  ######
+*/
+
+/**
+ * @brief puts a task into a WaitList. higher priorities go first, and tasks with the same priority
+ * are woken in the order they started waiting.
+ * interrupts must be dissabled before calling this.
+ * 
+ * @param list the list to insert into
+ * @param t the task to insert
+ */
+static void waitInsert(WaitList &list, TaskID t) {
+    TaskID *n = &list.head;
+#ifdef NO_PRIORITIES
+    while (*n != NO_TASK) {
+#else
+    while (*n != NO_TASK && tasks[*n].prio >= tasks[t].prio) {
+#endif
+        n = &tasks[*n].waitNext;
+    }
+    tasks[t].waitNext = *n;
+    *n = t;
+    tasks[t].waitingOn = &list;
+}
+
+bool Scheduler::wait(WaitList &list, unsigned long timeout) {
+    waitInsert(list, curr);
+    tasks[curr].timedOut = false;
+
+    // WAIT_FOREVER is not over LONG_MAX where longs are 64 bits
+    if (timeout == WAIT_FOREVER || timeout > LONG_MAX) {
+        readyRemove(curr, TASK_WAITING);
+    } else {
+        readyRemove(curr, TASK_WAITING | TASK_SLEEP_MS);
+        sleepInsert(msSleepers, millis() + timeout);
+    }
+    yield();
+    return !tasks[curr].timedOut;
+}
+
+TaskID Scheduler::wake(WaitList &list) {
+    TaskID t = list.head;
+    if (t == NO_TASK) {
+        return NO_TASK;
+    }
+    list.head = tasks[t].waitNext;
+    // if it was waiting with a timeout, it is also in a sleeping list
+    if (tasks[t].state & TASK_SLEEP_MS) {
+        sleepRemove(msSleepers, t);
+    }
+    readyAdd(t);
+    return t;
+}
+
+Priority Scheduler::getPriority(TaskID t) {
+#ifdef NO_PRIORITIES
+    return 0;
+#else
+    return tasks[t].prio;
+#endif
+}
+
+Priority Scheduler::getBasePriority(TaskID t) {
+#ifdef NO_PRIORITIES
+    return 0;
+#else
+    return tasks[t].base;
+#endif
+}
+
+#ifndef NO_PRIORITIES
+/**
+ * @brief changes the priority a task runs at, moving it to the ready mask and place in line that go with it.
+ * interrupts must be dissabled before calling this.
+ * 
+ * @param t the task to change
+ * @param priority the priority to run at
+ */
+static void runAt(TaskID t, Priority priority) {
+    if (tasks[t].prio == priority) {
+        return;
+    }
+    if (tasks[t].state == TASK_READY) {
+        // move it over to the ready mask of its new priority
+        readyRemove(t, TASK_READY);
+        tasks[t].prio = priority;
+        readyAdd(t);
+    } else {
+        tasks[t].prio = priority;
+    }
+    if (tasks[t].state & TASK_WAITING) {
+        // keep the WaitList in priority order
+        WaitList* list = tasks[t].waitingOn;
+        waitRemove(t);
+        waitInsert(*list, t);
+    }
+}
+#endif
+
+void Scheduler::setPriority(TaskID t, Priority priority) {
+#ifndef NO_PRIORITIES
+    if (priority >= ARDRTOS_PRIORITY_COUNT) {
+        priority = ARDRTOS_PRIORITY_COUNT - 1;
+    }
+    tasks[t].base = priority;
+    restorePriority(t);
+#endif
+}
+
+void Scheduler::raisePriority(TaskID t, Priority priority) {
+#ifndef NO_PRIORITIES
+    if (priority > tasks[t].prio) {
+        runAt(t, priority);
+    }
+#endif
+}
+
+void Scheduler::restorePriority(TaskID t) {
+#ifndef NO_PRIORITIES
+    Priority p = tasks[t].base;
+    for (Mutex* m = tasks[t].held; m != 0; m = m->_nextHeld) {
+        // waiters are kept highest priority first
+        TaskID w = m->_waiters.head;
+        if (w != NO_TASK && tasks[w].prio > p) {
+            p = tasks[w].prio;
+        }
+    }
+    runAt(t, p);
+#endif
+}
+
+void Scheduler::holdMutex(TaskID t, Mutex* m) {
+#ifndef NO_PRIORITIES
+    m->_nextHeld = tasks[t].held;
+    tasks[t].held = m;
+    // whoever is still waiting on it is now waiting on t
+    restorePriority(t);
+#endif
+}
+
+void Scheduler::releaseMutex(TaskID t, Mutex* m) {
+#ifndef NO_PRIORITIES
+    Mutex** n = &tasks[t].held;
+    while (*n != 0 && *n != m) {
+        n = &(*n)->_nextHeld;
+    }
+    if (*n != 0) {
+        *n = m->_nextHeld;
+    }
+    restorePriority(t);
+#endif
+}
+
+void Scheduler::notifyFromISR(TaskID t, unsigned long value, NotifyAction action) {
+    if (action == NOTIFY_SET_BITS) {
+        tasks[t].notifyValue |= value;
+    } else if (action == NOTIFY_INCREMENT) {
+        tasks[t].notifyValue++;
+    } else {
+        tasks[t].notifyValue = value;
+    }
+    tasks[t].notified = true;
+    wake(tasks[t].notifyWait);
+}
+
+void Scheduler::notify(TaskID t, unsigned long value, NotifyAction action) {
+    noInterrupts();
+    notifyFromISR(t, value, action);
+    interrupts();
+}
+
+void Scheduler::notifyFromISR(TaskID t) {
+    notifyFromISR(t, 0, NOTIFY_INCREMENT);
+}
+
+void Scheduler::notify(TaskID t) {
+    notify(t, 0, NOTIFY_INCREMENT);
+}
+
+bool Scheduler::waitNotify(unsigned long &value, unsigned long timeout) {
+    noInterrupts();
+    if (!tasks[curr].notified) {
+        if (timeout == 0) {
+            interrupts();
+            return false;
+        }
+        if (!wait(tasks[curr].notifyWait, timeout)) {
+            return false;
+        }
+        noInterrupts();
+    }
+    value = tasks[curr].notifyValue;
+    tasks[curr].notifyValue = 0;
+    tasks[curr].notified = false;
+    interrupts();
+    return true;
+}
+
+bool Scheduler::waitNotify(unsigned long timeout) {
+    unsigned long value;
+    return waitNotify(value, timeout);
 }
 
 TaskID Scheduler::getTaskID() {
@@ -179,6 +1423,72 @@ TaskID Scheduler::getTaskID() {
     return curr;
 }
 
+unsigned Scheduler::getStackHighWater(TaskID t) {
+    // the painted area is only ever written from the top down, so the first changed byte from the bottom is the peak.
+    uint8_t* p = tasks[t].stack + sizeof(unsigned);
+    uint8_t* top = tasks[t].stack + tasks[t].ss;
+    while (p < top && *p == STACK_PAINT) {
+        p++;
+    }
+    return top - p;
+}
+
+#ifdef TASK_STATS
+TaskStats Scheduler::getStats(TaskID t) {
+    noInterrupts();
+    TaskStats st = tasks[t].stats;
+    if (t == curr) {
+        // include the run that is still going on
+        unsigned long ran = micros() - switchedIn;
+        st.runTime += ran;
+        if (ran > st.longestRun) {
+            st.longestRun = ran;
+        }
+    }
+    interrupts();
+    return st;
+}
+
+SchedulerStats Scheduler::getStats() {
+    SchedulerStats st;
+    noInterrupts();
+    st.switches = totalSwitches;
+    st.idleTime = idleTime;
+    st.spuriousWakeups = spuriousWakeups;
+    interrupts();
+    return st;
+}
+
+void Scheduler::resetStats() {
+    noInterrupts();
+    for (TaskID t = 0; t <= numt; t++) {
+        tasks[t].stats.runTime = 0;
+        tasks[t].stats.switches = 0;
+        tasks[t].stats.longestRun = 0;
+    }
+    totalSwitches = 0;
+    idleTime = 0;
+    spuriousWakeups = 0;
+    // the current run starts counting from now
+    switchedIn = micros();
+    interrupts();
+}
+#endif
+
+unsigned long Scheduler::getIdleTime() {
+    noInterrupts();
+    unsigned long t = idleTime;
+    interrupts();
+    return t;
+}
+
+unsigned long Scheduler::getSpuriousWakeups() {
+    noInterrupts();
+    unsigned long n = spuriousWakeups;
+    interrupts();
+    return n;
+}
+
 /**
  * MIT License
  * 
@@ -0,0 +1,133 @@
+/**
+ * @file softTimer.cpp
+ * @author Alex Olson (aolson1714@gmail.com)
+ * @brief the timer task and the list of running SoftTimers
+ * @version 0.1
+ * @date 2022-04-03
+ * 
+ * @copyright MIT Copyright (c) 2022 Alex Olson. All rights reserved. details at bottom of file.
+ * 
+ */
+
+//! INCLUDES BEGIN
+#include "ArdRTOS.h"
+//! INCLUDES END
+
+// running timers sorted by when they are due, soonest first
+static SoftTimer* active = 0;
+
+// the timer task. NO_TASK until it has ran for the first time.
+static TaskID daemon = NO_TASK;
+
+SoftTimer::SoftTimer(osFuncCall callback, unsigned long period, bool autoReload) :
+    _fc(callback), _arg(0), _period(period == 0 ? 1 : period), _expiry(0), _reload(autoReload), _running(false), _next(0) {
+}
+
+SoftTimer::SoftTimer(osFuncCallArg callback, void* arg, unsigned long period, bool autoReload) :
+    _fc((osFuncCall)callback), _arg(arg), _period(period == 0 ? 1 : period), _expiry(0), _reload(autoReload), _running(false), _next(0) {
+}
+
+void SoftTimer::addTask(unsigned stackSize, Priority priority) {
+    OS.addTask(run, stackSize, priority);
+}
+
+void SoftTimer::insert() {
+    SoftTimer** n = &active;
+    // compared by their signed difference so that the list survives millis() rolling over
+    while (*n != 0 && (long)(_expiry - (*n)->_expiry) >= 0) {
+        n = &(*n)->_next;
+    }
+    _next = *n;
+    *n = this;
+    _running = true;
+    // the timer task might be asleep waiting on a later timer
+    if (active == this && daemon != NO_TASK) {
+        OS.notifyFromISR(daemon);
+    }
+}
+
+void SoftTimer::remove() {
+    SoftTimer** n = &active;
+    while (*n != this) {
+        n = &(*n)->_next;
+    }
+    *n = _next;
+    _running = false;
+}
+
+void SoftTimer::start() {
+    noInterrupts();
+    if (_running) {
+        remove();
+    }
+    _expiry = millis() + _period;
+    insert();
+    interrupts();
+}
+
+void SoftTimer::stop() {
+    noInterrupts();
+    if (_running) {
+        remove();
+    }
+    interrupts();
+}
+
+void SoftTimer::changePeriod(unsigned long period) {
+    _period = period == 0 ? 1 : period;
+    start();
+}
+
+void SoftTimer::run() {
+    daemon = OS.getTaskID();
+
+    noInterrupts();
+    unsigned long now = millis();
+    while (active != 0 && (long)(now - active->_expiry) >= 0) {
+        SoftTimer* t = active;
+        t->remove();
+        if (t->_reload) {
+            // counted from when it was due instead of from now, so the period does not drift
+            t->_expiry += t->_period;
+            t->insert();
+        }
+        // the callback might start or stop timers itself
+        interrupts();
+        if (t->_arg != 0) {
+            ((osFuncCallArg)t->_fc)(t->_arg);
+        } else {
+            t->_fc();
+        }
+        noInterrupts();
+        now = millis();
+    }
+    unsigned long sleep = active == 0 ? WAIT_FOREVER : active->_expiry - now;
+    interrupts();
+
+    // start() notifies us when a timer is due sooner than the one we are sleeping for
+    OS.waitNotify(sleep);
+}
+
+/**
+ * MIT License
+ * 
+ * Copyright (c) 2022 Alex Olson
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */